@@ -25,6 +25,10 @@ android {
             )
         }
     }
+    androidResources {
+        // KTX2 textures are mapped straight out of the APK (see core/asset.h)
+        noCompress += "ktx2"
+    }
     externalNativeBuild {
         cmake {
             path = file("src/main/cpp/CMakeLists.txt")
@@ -0,0 +1,229 @@
+/*
+ * Recording GL stub for host builds. Nothing is rendered: object names are handed out from a
+ * counter and every entry point bumps gl_stub_stats so the benchmark can report how much work a
+ * frame submits.
+ */
+#include "core/gles.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+GlStubStats gl_stub_stats;
+
+static GLuint next_name = 1;
+static const char *stub_version = "OpenGL ES 3.0 u3d-stub";
+static const char *stub_extensions =
+        "GL_OES_vertex_array_object GL_OES_vertex_half_float GL_KHR_parallel_shader_compile "
+        "GL_KHR_texture_compression_astc_ldr";
+
+void gl_stub_reset_stats(void) {
+    memset(&gl_stub_stats, 0, sizeof(gl_stub_stats));
+}
+
+void gl_stub_set_version(const char *version) {
+    stub_version = version;
+}
+
+void gl_stub_set_extensions(const char *extensions) {
+    stub_extensions = extensions;
+}
+
+#define CALL()    (gl_stub_stats.calls++)
+#define STATE()   (gl_stub_stats.calls++, gl_stub_stats.state_calls++)
+#define UNIFORM() (gl_stub_stats.calls++, gl_stub_stats.uniform_calls++)
+#define DRAW()    (gl_stub_stats.calls++, gl_stub_stats.draw_calls++)
+
+/* ================= OBJECTS ================= */
+
+void glGenBuffers(GLsizei n, GLuint *buffers) {
+    CALL();
+    for (GLsizei i = 0; i < n; i++) buffers[i] = next_name++;
+}
+
+void glBufferData(GLenum, GLsizeiptr, const void *, GLenum) { CALL(); }
+
+/* Every mapping is the same scratch block, grown to the largest range asked for. */
+static void  *mapped;
+static size_t mapped_size;
+
+void *glMapBufferRange(GLenum, GLintptr, GLsizeiptr length, GLbitfield) {
+    CALL();
+    if ((size_t) length > mapped_size) {
+        mapped_size = (size_t) length;
+        mapped = realloc(mapped, mapped_size);
+    }
+    return mapped;
+}
+
+GLboolean glUnmapBuffer(GLenum) { CALL(); return GL_TRUE; }
+
+void glGenVertexArrays(GLsizei n, GLuint *arrays) {
+    CALL();
+    for (GLsizei i = 0; i < n; i++) arrays[i] = next_name++;
+}
+
+/* ================= TEXTURES ================= */
+
+void glGenTextures(GLsizei n, GLuint *textures) {
+    CALL();
+    for (GLsizei i = 0; i < n; i++) textures[i] = next_name++;
+}
+
+void glDeleteTextures(GLsizei, const GLuint *) { CALL(); }
+void glTexParameteri(GLenum, GLenum, GLint) { CALL(); }
+void glTexImage2D(GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const void *) {
+    CALL();
+}
+void glTexStorage2D(GLenum, GLsizei, GLenum, GLsizei, GLsizei) { CALL(); }
+void glTexSubImage2D(GLenum, GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLenum,
+                     const void *) {
+    CALL();
+}
+void glCompressedTexSubImage2D(GLenum, GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLsizei,
+                               const void *) {
+    CALL();
+}
+void glGenerateMipmap(GLenum) { CALL(); }
+
+/* ================= PROGRAMS =================
+ * Compiles and links always succeed. A program binary is a fixed tag in STUB_BINARY_FORMAT and
+ * glProgramBinary accepts exactly that, so a cache written by the stub reloads while anything
+ * else is rejected, as after a driver update.
+ */
+
+#define STUB_BINARY_FORMAT 0x5533
+
+#define STUB_MAX_NAMES 4096
+
+static const char stub_binary[] = "u3d-stub-program";
+static GLint link_status = GL_TRUE;   // of the last link or binary load
+static int   link_polls;
+static uint16_t polls_left[STUB_MAX_NAMES];   // per program name, until its link completes
+
+void gl_stub_set_link_polls(int polls) {
+    link_polls = polls;
+}
+
+GLuint glCreateShader(GLenum) { CALL(); return next_name++; }
+void glShaderSource(GLuint, GLsizei, const GLchar *const *, const GLint *) { CALL(); }
+void glCompileShader(GLuint) { CALL(); }
+void glDeleteShader(GLuint) { CALL(); }
+
+void glGetShaderiv(GLuint, GLenum pname, GLint *params) {
+    CALL();
+    *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+}
+
+void glGetShaderInfoLog(GLuint, GLsizei size, GLsizei *length, GLchar *log) {
+    CALL();
+    if (length) *length = 0;
+    if (size > 0) log[0] = '\0';
+}
+
+GLuint glCreateProgram(void) { CALL(); return next_name++; }
+void glDeleteProgram(GLuint) { CALL(); }
+void glAttachShader(GLuint, GLuint) { CALL(); }
+void glBindAttribLocation(GLuint, GLuint, const GLchar *) { CALL(); }
+void glProgramParameteri(GLuint, GLenum, GLint) { CALL(); }
+void glMaxShaderCompilerThreadsKHR(GLuint) { CALL(); }
+void glLinkProgram(GLuint program) {
+    CALL();
+    link_status = GL_TRUE;
+    polls_left[program % STUB_MAX_NAMES] = (uint16_t) link_polls;
+}
+
+void glGetProgramiv(GLuint program, GLenum pname, GLint *params) {
+    CALL();
+    switch (pname) {
+        case GL_LINK_STATUS:           *params = link_status; break;
+        case GL_PROGRAM_BINARY_LENGTH: *params = (GLint) sizeof(stub_binary); break;
+        case GL_COMPLETION_STATUS_KHR: {
+            uint16_t *left = &polls_left[program % STUB_MAX_NAMES];
+            *params = *left == 0;
+            if (*left > 0)
+                (*left)--;
+            break;
+        }
+        default:                       *params = 0; break;
+    }
+}
+
+void glGetProgramInfoLog(GLuint, GLsizei size, GLsizei *length, GLchar *log) {
+    CALL();
+    if (length) *length = 0;
+    if (size > 0) log[0] = '\0';
+}
+
+void glGetProgramBinary(GLuint, GLsizei size, GLsizei *length, GLenum *format, void *binary) {
+    CALL();
+    GLsizei n = size < (GLsizei) sizeof(stub_binary) ? size : (GLsizei) sizeof(stub_binary);
+    memcpy(binary, stub_binary, (size_t) n);
+    if (length) *length = n;
+    *format = STUB_BINARY_FORMAT;
+}
+
+void glProgramBinary(GLuint, GLenum format, const void *binary, GLsizei length) {
+    CALL();
+    link_status = format == STUB_BINARY_FORMAT && length == (GLsizei) sizeof(stub_binary) &&
+                  !memcmp(binary, stub_binary, sizeof(stub_binary));
+}
+
+GLint glGetUniformLocation(GLuint, const GLchar *) { CALL(); return (GLint) next_name++; }
+
+void glGetIntegerv(GLenum pname, GLint *data) {
+    CALL();
+    *data = pname == GL_NUM_PROGRAM_BINARY_FORMATS ? 1 : 0;
+}
+
+const GLubyte *glGetString(GLenum name) {
+    CALL();
+    if (name == GL_VERSION) return (const GLubyte *) stub_version;
+    if (name == GL_EXTENSIONS) return (const GLubyte *) stub_extensions;
+    return (const GLubyte *) "u3d-stub";
+}
+
+/* ================= STATE ================= */
+
+void glUseProgram(GLuint) { STATE(); }
+void glBindBuffer(GLenum, GLuint) { STATE(); }
+void glBindVertexArray(GLuint) { STATE(); }
+void glBindTexture(GLenum, GLuint) { STATE(); }
+void glVertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const void *) { STATE(); }
+void glEnableVertexAttribArray(GLuint) { STATE(); }
+void glVertexAttribDivisor(GLuint, GLuint) { STATE(); }
+void glDisableVertexAttribArray(GLuint) { STATE(); }
+void glEnable(GLenum) { STATE(); }
+void glDisable(GLenum) { STATE(); }
+void glDepthFunc(GLenum) { STATE(); }
+void glDepthMask(GLboolean) { STATE(); }
+void glBlendFunc(GLenum, GLenum) { STATE(); }
+void glLineWidth(GLfloat) { STATE(); }
+void glViewport(GLint, GLint, GLsizei, GLsizei) { STATE(); }
+void glClearColor(GLfloat, GLfloat, GLfloat, GLfloat) { STATE(); }
+
+/* ================= UNIFORMS ================= */
+
+void glUniform1f(GLint, GLfloat) { UNIFORM(); }
+void glUniform2f(GLint, GLfloat, GLfloat) { UNIFORM(); }
+void glUniformMatrix4fv(GLint, GLsizei, GLboolean, const GLfloat *) { UNIFORM(); }
+
+/* ================= DRAW ================= */
+
+void glClear(GLbitfield) { CALL(); }
+void glDrawArrays(GLenum, GLint, GLsizei) { DRAW(); }
+void glDrawArraysInstanced(GLenum, GLint, GLsizei, GLsizei) { DRAW(); }
+void glDrawElements(GLenum, GLsizei, GLenum, const void *) { DRAW(); }
+void glDrawElementsInstanced(GLenum, GLsizei, GLenum, const void *, GLsizei) { DRAW(); }
+
+/* ================= EXTENSIONS ================= */
+
+/* The OES_vertex_array_object and OES_get_program_binary entry points behave exactly like the
+ * ES3 ones. */
+void *gl_stub_proc_address(const char *name) {
+    if (!strcmp(name, "glGenVertexArraysOES")) return (void *) glGenVertexArrays;
+    if (!strcmp(name, "glBindVertexArrayOES")) return (void *) glBindVertexArray;
+    if (!strcmp(name, "glGetProgramBinaryOES")) return (void *) glGetProgramBinary;
+    if (!strcmp(name, "glProgramBinaryOES")) return (void *) glProgramBinary;
+    if (!strcmp(name, "glMaxShaderCompilerThreadsKHR")) return (void *) glMaxShaderCompilerThreadsKHR;
+    return NULL;
+}
@@ -0,0 +1,792 @@
+/*
+ * Headless host benchmark for u3d_core. Drives the same input -> simulation -> draw submission
+ * path as android_main, against the recording GL stub, and prints per-stage timings.
+ *
+ *   u3d_bench [frames] [--es2] [--no-ext] [--agents N] [--hz N] [--paced] [--threads]
+ *             [--jobs N] [--shader-cache DIR] [--link-polls N] [--textures N]
+ *             [--upload-budget KB] [--assets DIR] [--asset-threads N] [--ktx2 etc2|astc]
+ *             [--asset-failures]
+ *
+ * frames must be a bare number. Anything else, including --help or an option without its value,
+ * prints this usage to stderr and exits with 2.
+ * --es2 makes the stub report an ES2 context so the non-instanced fallback paths are measured.
+ * --no-ext makes the stub report no extensions (e.g. no OES_vertex_array_object on ES2).
+ * --agents N spawns N extra spinning agents on a grid; one of them is destroyed and respawned
+ * every frame so entity churn is measured too.
+ * --hz N sets the display rate frames are clocked at (default 60); the sim stays at SIM_HZ.
+ * --paced sleeps on the monotonic frame clock instead of running flat out, and reports how
+ * late each frame started.
+ * --threads runs the simulation on the sim thread as on device (implies --paced): this loop only
+ * posts touches and draws snapshots, and entity churn is skipped.
+ * --jobs N starts N job workers (default: one per core minus one; 0 runs jobs inline). Unpaced
+ * runs print checksums of the final poses and of the character world matrices computed from
+ * them, neither of which may change with N.
+ * --shader-cache DIR keeps program binaries in DIR (must exist), so a second run loads them
+ * instead of compiling.
+ * --link-polls N makes each program link take N completion queries in the stub, as if the driver
+ * were compiling in the background; the programs line reports the frame all were ready by.
+ * --textures N queues N mipmapped 1024x1024 RGBA images for upload after init, and
+ * --upload-budget KB sets the bytes texture_pump may stream per frame; the textures line reports
+ * the frame all were ready by and the most any frame uploaded.
+ * --assets DIR writes BENCH_MODELS models (an OBJ mesh and a 256x256 PAM texture each, sharing
+ * one program) into DIR (must exist) and loads them through core/asset_task.h once init is
+ * done, awaiting each model in a coroutine; the assets line counts the models it resumed with;
+ * --asset-failures also loads, next to those, a mesh that does not parse, a missing texture and
+ * models needing either, checks that each fails with that reason and that repeated loads share
+ * ids, and exits with 1 unless all of that held.
+ * --asset-threads N sets the loader threads (default: one per core, 0 loads inline). Add --paced
+ * for a meaningful load time: unpaced frames can all finish before the loaders are scheduled.
+ * --ktx2 etc2|astc writes the textures as KTX2 with their full mip chain instead, in ETC2 RGB8
+ * (8x smaller than RGBA8) or ASTC 4x4 (4x); with --es2 both go through the CPU decoders. The
+ * textures line reports the storage all textures take.
+ */
+#include "core/agents.h"
+#include "core/asset.h"
+#include "core/asset_task.h"
+#include "core/camera.h"
+#include "core/cull.h"
+#include "core/ecs.h"
+#include "core/engine.h"
+#include "core/gl_caps.h"
+#include "core/gl_state.h"
+#include "core/gles.h"
+#include "core/input.h"
+#include "core/jobs.h"
+#include "core/mat4.h"
+#include "core/mesh.h"
+#include "core/pacing.h"
+#include "core/pick.h"
+#include "core/program.h"
+#include "core/render_queue.h"
+#include "core/scene.h"
+#include "core/sim_thread.h"
+#include "core/snapshot.h"
+#include "core/spatial.h"
+#include "core/texture.h"
+#include "core/transform.h"
+#include "core/ui.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_WIDTH  1920
+#define BENCH_HEIGHT 1080
+
+/* ================= TIMING ================= */
+
+static double now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec * 1e-3;
+}
+
+typedef struct {
+    const char *name;
+    double total, min, max;
+} Stage;
+
+static void stage_add(Stage *s, double us) {
+    s->total += us;
+    if (us < s->min) s->min = us;
+    if (us > s->max) s->max = us;
+}
+
+/* ================= SYNTHETIC INPUT =================
+ * A repeating 120-frame script: grab the player's torso (wherever the camera currently shows
+ * it) and drag it for half a second, then a two-finger pinch/orbit of the camera. The player
+ * is located through the latest snapshot, so the script also works with --threads.
+ */
+
+static bool threaded;
+static const SceneSnapshot *latest;
+
+static void player_on_screen(float *sx, float *sy) {
+    *sx = *sy = 0.0f;
+    if (!latest)
+        return;
+    int i = 0;
+    while (i < latest->count && latest->entity[i] != latest->engine.player)
+        i++;
+    if (i == latest->count)
+        return;
+
+    FrameConstants fc;
+    fc.aspect = 0.0f;
+    frame_constants_build(&fc, &latest->engine);
+    const float *m = fc.view_proj;
+    const float *const *pose = latest->pose;
+    float p[3] = {pose[SNAP_X][i], pose[SNAP_Y][i] + 0.6f, pose[SNAP_Z][i]};
+    float clip[4];
+    for (int r = 0; r < 4; r++)
+        clip[r] = m[r] * p[0] + m[4 + r] * p[1] + m[8 + r] * p[2] + m[12 + r];
+
+    *sx = (clip[0] / clip[3] * 0.5f + 0.5f) * BENCH_WIDTH;
+    *sy = (0.5f - clip[1] / clip[3] * 0.5f) * BENCH_HEIGHT;
+}
+
+static void touch(int action, int pointers, float x0, float y0, float x1, float y1) {
+    TouchEvent e;
+    e.action = action;
+    e.pointer_count = pointers;
+    e.x[0] = x0; e.y[0] = y0;
+    e.x[1] = x1; e.y[1] = y1;
+    if (threaded)
+        sim_post_touch(&e);
+    else
+        input_touch(&e);
+}
+
+static void bench_input(int frame) {
+    static float grab_x, grab_y;
+    int f = frame % 120;
+    float w = BENCH_WIDTH, h = BENCH_HEIGHT;
+
+    if (f == 0)
+        player_on_screen(&grab_x, &grab_y);
+    float drag_x = grab_x + (f % 30) * 4.0f;
+
+    if (f == 0)       touch(TOUCH_DOWN, 1, drag_x, grab_y, 0, 0);
+    else if (f < 59)  touch(TOUCH_MOVE, 1, drag_x, grab_y, 0, 0);
+    else if (f == 59) touch(TOUCH_UP, 1, drag_x, grab_y, 0, 0);
+    else if (f == 60) touch(TOUCH_DOWN, 1, w * 0.4f, h * 0.3f, 0, 0);
+    else if (f == 61) touch(TOUCH_POINTER_DOWN, 2, w * 0.4f, h * 0.3f, w * 0.6f, h * 0.7f);
+    else if (f < 110) touch(TOUCH_MOVE, 2, w * 0.4f - f, h * 0.3f, w * 0.6f + f, h * 0.7f);
+    else if (f == 110) touch(TOUCH_POINTER_UP, 2, w * 0.4f, h * 0.3f, w * 0.6f, h * 0.7f);
+    else if (f == 111) touch(TOUCH_UP, 1, w * 0.4f, h * 0.3f, 0, 0);
+}
+
+/* ================= CROWD =================
+ * Extra agents laid out on a square grid, each with some initial spin.
+ */
+
+static Entity *crowd;
+static int crowd_count;
+
+static Entity crowd_spawn(int i) {
+    int side = 1;
+    while (side * side < crowd_count) side++;
+
+    Entity e = agent_spawn((i % side) * 1.5f - side * 0.75f, 0.0f, 4.0f + (i / side) * 1.5f);
+    float *rot_vel = ecs_get(e, FIELD_ROT_VEL);
+    if (rot_vel)
+        *rot_vel = 0.02f + (i % 7) * 0.01f;
+    return e;
+}
+
+static void crowd_init(int count) {
+    crowd_count = count;
+    crowd = (Entity *) malloc(sizeof(Entity) * (count > 0 ? count : 1));
+    for (int i = 0; i < count; i++)
+        crowd[i] = crowd_spawn(i);
+}
+
+static void crowd_churn(int frame) {
+    if (crowd_count == 0)
+        return;
+    int i = frame % crowd_count;
+    agent_destroy(crowd[i]);
+    crowd[i] = crowd_spawn(i);
+}
+
+/* ================= SPATIAL =================
+ * Query cost against whatever is in the index (run with --agents for a meaningful number).
+ */
+
+#define SPATIAL_REPS 2000
+
+static void bench_spatial() {
+    static Entity out[256];
+    double hits = 0;
+
+    double t0 = now_us();
+    for (int r = 0; r < SPATIAL_REPS; r++)
+        hits += spatial_query_radius((r % 50) * 1.5f - 30.0f, 0.0f, 4.0f + (r % 40), 3.0f, out, 256);
+    double t1 = now_us();
+    for (int r = 0; r < SPATIAL_REPS; r++)
+        hits += spatial_query_nearest((r % 50) * 1.5f - 30.0f, 0.0f, 4.0f + (r % 40), 8, 1e30f, out, NULL);
+    double t2 = now_us();
+
+    printf("spatial us/query (%d entities): radius %.3f, nearest-8 %.3f (hits %.0f)\n",
+           spatial_count(), (t1 - t0) / SPATIAL_REPS, (t2 - t1) / SPATIAL_REPS, hits);
+}
+
+/* ================= PICKING =================
+ * Rays through a sweep of screen points with the final camera pose.
+ */
+
+#define PICK_REPS 2000
+
+static void bench_pick() {
+    frame_constants_update();
+    float origin[3], dir[3], t;
+    pick_ray(frame_constants.eye, frame_constants.eye, &t, NULL);   // bring the BVH up to date
+
+    int hits = 0;
+    double t0 = now_us();
+    for (int r = 0; r < PICK_REPS; r++) {
+        pick_ray_from_ndc((r % 64) / 32.0f - 1.0f, ((r / 64) % 32) / 16.0f - 1.0f, origin, dir);
+        hits += pick_ray(origin, dir, &t, NULL) != ENTITY_NONE;
+    }
+    double t1 = now_us();
+
+    printf("pick us/ray (%d characters): %.3f (hits %d/%d)\n",
+           ecs_count(AGENT_COMPONENTS), (t1 - t0) / PICK_REPS, hits, PICK_REPS);
+}
+
+/* ================= MATH =================
+ * Throughput of the matrix entry points over a batch the size of a few hundred characters'
+ * body parts, reported as nanoseconds per matrix.
+ */
+
+#define MATH_BATCH 1536
+#define MATH_REPS  200
+
+static void bench_math() {
+    static float a[16], b[MATH_BATCH * 16], o[MATH_BATCH * 16], pts[MATH_BATCH * 3];
+    mat4_translate_rotate_y(a, 1.0f, 2.0f, 3.0f, 0.5f);
+    for (int i = 0; i < MATH_BATCH; i++) {
+        mat4_translate_rotate_y(b + i * 16, (float) i, 0.5f, -(float) i, i * 0.01f);
+        pts[i * 3] = (float) i; pts[i * 3 + 1] = 1.0f; pts[i * 3 + 2] = -2.0f;
+    }
+
+    double n = (double) MATH_BATCH * MATH_REPS;
+    double t0 = now_us();
+    for (int r = 0; r < MATH_REPS; r++)
+        for (int i = 0; i < MATH_BATCH; i++) mat4_mul(o + i * 16, a, b + i * 16);
+    double t1 = now_us();
+    for (int r = 0; r < MATH_REPS; r++) mat4_mul_many(o, a, b, MATH_BATCH);
+    double t2 = now_us();
+    for (int r = 0; r < MATH_REPS; r++) mat4_mul_affine_many(o, a, b, MATH_BATCH);
+    double t3 = now_us();
+    for (int r = 0; r < MATH_REPS; r++) mat4_transform_points(pts, a, pts, MATH_BATCH);
+    double t4 = now_us();
+
+    printf("mat4 ns/op: mul %.2f, mul_many %.2f, mul_affine_many %.2f, transform_points %.2f"
+           " (check %.3f)\n",
+           (t1 - t0) * 1e3 / n, (t2 - t1) * 1e3 / n, (t3 - t2) * 1e3 / n, (t4 - t3) * 1e3 / n,
+           o[MATH_BATCH * 16 - 4] + pts[0]);
+}
+
+/* ================= TEXTURES =================
+ * Stand-ins for decoded assets: a gradient per image, so no two are alike.
+ */
+
+#define BENCH_TEXTURE_SIZE 1024
+
+static uint8_t **texture_images;
+
+static void textures_decode(int count) {
+    texture_images = (uint8_t **) malloc(sizeof(uint8_t *) * (count > 0 ? count : 1));
+    for (int t = 0; t < count; t++) {
+        uint8_t *p = (uint8_t *) malloc((size_t) BENCH_TEXTURE_SIZE * BENCH_TEXTURE_SIZE * 4);
+        texture_images[t] = p;
+        for (int y = 0; y < BENCH_TEXTURE_SIZE; y++)
+            for (int x = 0; x < BENCH_TEXTURE_SIZE; x++, p += 4) {
+                p[0] = (uint8_t) x;
+                p[1] = (uint8_t) y;
+                p[2] = (uint8_t) (t * 37);
+                p[3] = 255;
+            }
+    }
+}
+
+static void textures_submit(int count) {
+    for (int t = 0; t < count; t++)
+        texture_submit(texture_images[t], BENCH_TEXTURE_SIZE, BENCH_TEXTURE_SIZE, true);
+    free(texture_images);
+}
+
+/* ================= ASSETS =================
+ * A directory of models to load: the same cube, scaled differently per model so no two files
+ * are alike, and a gradient texture each.
+ */
+
+#define BENCH_MODELS       100
+#define BENCH_ASSET_SIZE   256
+
+static const char bench_model_vs[] =
+        "attribute vec3 aPos;\n"
+        "attribute vec3 aNormal;\n"
+        "attribute vec2 aUV;\n"
+        "uniform mat4 uViewProj;\n"
+        "varying vec2 vUV;\n"
+        "void main() { vUV = aUV; gl_Position = uViewProj * vec4(aPos, 1.0); }\n";
+
+static const char bench_model_fs[] =
+        "precision mediump float;\n"
+        "uniform sampler2D uTexture;\n"
+        "varying vec2 vUV;\n"
+        "void main() { gl_FragColor = texture2D(uTexture, vUV); }\n";
+
+static const char *const bench_model_attribs[] = {"aPos", "aNormal", "aUV"};
+
+static bool write_file(const char *path, const void *data, size_t size) {
+    FILE *f = fopen(path, "wb");
+    if (!f)
+        return false;
+    bool ok = fwrite(data, 1, size, f) == size;
+    return fclose(f) == 0 && ok;
+}
+
+static bool write_cube(const char *path, float scale) {
+    static const int faces[6][4] = {
+            {1, 2, 3, 4}, {8, 7, 6, 5}, {1, 5, 6, 2}, {2, 6, 7, 3}, {3, 7, 8, 4}, {5, 1, 4, 8},
+    };
+    FILE *f = fopen(path, "w");
+    if (!f)
+        return false;
+    for (int i = 0; i < 8; i++)
+        fprintf(f, "v %g %g %g\n", (i & 1 ? 1 : -1) * scale, (i & 2 ? 1 : -1) * scale,
+                (i & 4 ? 1 : -1) * scale);
+    fprintf(f, "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n");
+    for (const int *q : faces)
+        fprintf(f, "f %d/1 %d/2 %d/3 %d/4\n", q[0], q[1], q[2], q[3]);
+    return fclose(f) == 0;
+}
+
+static bool write_pam(const char *path, int seed) {
+    static uint8_t image[128 + BENCH_ASSET_SIZE * BENCH_ASSET_SIZE * 4];
+    int header = snprintf((char *) image, 128,
+                          "P7\nWIDTH %d\nHEIGHT %d\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\n"
+                          "ENDHDR\n", BENCH_ASSET_SIZE, BENCH_ASSET_SIZE);
+    uint8_t *p = image + header;
+    for (int y = 0; y < BENCH_ASSET_SIZE; y++)
+        for (int x = 0; x < BENCH_ASSET_SIZE; x++, p += 4) {
+            p[0] = (uint8_t) x;
+            p[1] = (uint8_t) y;
+            p[2] = (uint8_t) (seed * 37);
+            p[3] = 255;
+        }
+    return write_file(path, image, (size_t) (p - image));
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++)
+        p[i] = (uint8_t) (v >> 8 * i);
+}
+
+static void put64(uint8_t *p, uint64_t v) {
+    put32(p, (uint32_t) v);
+    put32(p + 4, (uint32_t) (v >> 32));
+}
+
+/* The same gradient as write_pam, with its full mip chain, in blocks of one colour each: ETC2
+ * RGB8 differential blocks (zero delta, every pixel at +2) or ASTC 4x4 void-extent blocks. No
+ * data format descriptor: ktx2_parse goes by vkFormat alone. */
+static bool write_ktx2(const char *path, int seed, bool astc) {
+    static uint8_t file[80 + 24 * TEXTURE_MAX_LEVELS + 2 * BENCH_ASSET_SIZE * BENCH_ASSET_SIZE];
+    static const uint8_t void_extent[8] = {0xFC, 0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    int levels = 1;
+    for (int size = BENCH_ASSET_SIZE; size > 1; size >>= 1)
+        levels++;
+
+    memset(file, 0, 80 + 24 * levels);
+    memcpy(file, "\xABKTX 20\xBB\r\n\x1A\n", 12);
+    /* VK_FORMAT_ASTC_4x4_UNORM_BLOCK or VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK */
+    put32(file + 12, astc ? 157 : 147);
+    put32(file + 16, 1);
+    put32(file + 20, BENCH_ASSET_SIZE);
+    put32(file + 24, BENCH_ASSET_SIZE);
+    put32(file + 36, 1);
+    put32(file + 40, (uint32_t) levels);
+
+    size_t offset = 80 + 24 * levels;
+    for (int level = levels - 1; level >= 0; level--) {   // smallest first, as KTX2 stores them
+        offset = (offset + 15) & ~(size_t) 15;
+        int size = BENCH_ASSET_SIZE >> level, blocks = (size + 3) / 4;
+        uint8_t *p = file + offset;
+        for (int by = 0; by < blocks; by++)
+            for (int bx = 0; bx < blocks; bx++) {
+                int rgb[3] = {bx * 4 << level, by * 4 << level, (seed * 37) & 255};
+                if (astc) {
+                    memcpy(p, void_extent, 8);
+                    for (int k = 0; k < 4; k++) {
+                        int v = (k < 3 ? rgb[k] : 255) * 257;
+                        p[8 + k * 2] = (uint8_t) v;
+                        p[9 + k * 2] = (uint8_t) (v >> 8);
+                    }
+                    p += 16;
+                } else {
+                    uint64_t block = 1ull << 33;
+                    for (int k = 0; k < 3; k++)
+                        block |= (uint64_t) (rgb[k] >> 3) << (59 - 8 * k);
+                    for (int i = 7; i >= 0; i--, block >>= 8)
+                        p[i] = (uint8_t) block;
+                    p += 8;
+                }
+            }
+        size_t length = (size_t) (p - file) - offset;
+        put64(file + 80 + 24 * level, offset);
+        put64(file + 88 + 24 * level, length);
+        put64(file + 96 + 24 * level, length);
+        offset += length;
+    }
+    return write_file(path, file, offset);
+}
+
+/* "pam" or "ktx2", whichever --ktx2 asks for. */
+static const char *texture_extension(const char *ktx2) {
+    return ktx2 ? "ktx2" : "pam";
+}
+
+static bool assets_write(const char *dir, const char *ktx2) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/model.vs", dir);
+    bool ok = write_file(path, bench_model_vs, sizeof(bench_model_vs) - 1);
+    snprintf(path, sizeof(path), "%s/model.fs", dir);
+    ok = ok && write_file(path, bench_model_fs, sizeof(bench_model_fs) - 1);
+    for (int i = 0; ok && i < BENCH_MODELS; i++) {
+        snprintf(path, sizeof(path), "%s/model-%d.obj", dir, i);
+        ok = write_cube(path, 0.5f + i * 0.01f);
+        snprintf(path, sizeof(path), "%s/model-%d.%s", dir, i, texture_extension(ktx2));
+        if (ktx2)
+            ok = ok && write_ktx2(path, i, !strcmp(ktx2, "astc"));
+        else
+            ok = ok && write_pam(path, i);
+    }
+    return ok;
+}
+
+static int models_ready;   // models assets_load has resumed with
+
+static AssetTask assets_load(const char *dir, const char *ktx2) {
+    char vs[512], fs[512], mesh[512], texture[512];
+    snprintf(vs, sizeof(vs), "%s/model.vs", dir);
+    snprintf(fs, sizeof(fs), "%s/model.fs", dir);
+    AssetLoad<AssetProgram> program = load<AssetProgram>(vs, fs, bench_model_attribs, 3);
+    AssetLoad<AssetModel> models[BENCH_MODELS];
+    for (int i = 0; i < BENCH_MODELS; i++) {
+        snprintf(mesh, sizeof(mesh), "%s/model-%d.obj", dir, i);
+        snprintf(texture, sizeof(texture), "%s/model-%d.%s", dir, i, texture_extension(ktx2));
+        models[i] = load<AssetModel>(mesh, texture, program.id);
+    }
+    for (int i = 0; i < BENCH_MODELS; i++) {
+        AssetModel model = co_await models[i];
+        if (model && model.texture.name() && model.program)
+            models_ready++;
+    }
+}
+
+/* --asset-failures: a mesh that does not parse, a texture that does not exist, and models
+ * needing either must fail with those reasons, while repeated loads of the written files must
+ * return their first ids. Sets check_result once done: "" if every check held. */
+static const char *check_result;
+
+static AssetTask assets_check(const char *dir, const char *ktx2) {
+    static const char bad_obj[] = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 x\n";
+    char vs[512], fs[512], mesh[512], texture[512], bad[512], missing[512];
+    snprintf(vs, sizeof(vs), "%s/model.vs", dir);
+    snprintf(fs, sizeof(fs), "%s/model.fs", dir);
+    snprintf(mesh, sizeof(mesh), "%s/model-0.obj", dir);
+    snprintf(texture, sizeof(texture), "%s/model-0.%s", dir, texture_extension(ktx2));
+    snprintf(bad, sizeof(bad), "%s/check-bad.obj", dir);
+    snprintf(missing, sizeof(missing), "%s/check-missing.pam", dir);
+    if (!write_file(bad, bad_obj, sizeof(bad_obj) - 1)) {
+        check_result = "cannot write check-bad.obj";
+        co_return;
+    }
+
+    AssetId program = load<AssetProgram>(vs, fs, bench_model_attribs, 3).id;
+    int assets = asset_stats.assets;
+    if (load<AssetProgram>(vs, fs, bench_model_attribs, 3).id != program ||
+        load<Mesh>(mesh).id != load<Mesh>(mesh).id ||
+        load<AssetTexture>(texture).id != load<AssetTexture>(texture).id ||
+        asset_stats.assets != assets) {
+        check_result = "a repeated load got a new id";
+        co_return;
+    }
+
+    AssetLoad<Mesh> bad_mesh = load<Mesh>(bad);
+    AssetLoad<AssetTexture> no_texture = load<AssetTexture>(missing);
+    AssetLoad<AssetModel> needs_mesh = load<AssetModel>(bad, texture, program);
+    AssetLoad<AssetModel> needs_texture = load<AssetModel>(mesh, missing, program);
+    AssetLoad<AssetModel> good = load<AssetModel>(mesh, texture, program);
+    char needs[600];
+
+    if (co_await bad_mesh || !strstr(asset_failure(bad_mesh.id), "bad face on line 4")) {
+        check_result = "the broken OBJ did not fail on its bad face";
+        co_return;
+    }
+    if (co_await no_texture || !asset_failure(no_texture.id)[0]) {
+        check_result = "the missing texture did not fail";
+        co_return;
+    }
+    snprintf(needs, sizeof(needs), "needs %s", bad);
+    if (co_await needs_mesh || strcmp(asset_failure(needs_mesh.id), needs) != 0) {
+        check_result = "a model with the broken OBJ did not fail naming it";
+        co_return;
+    }
+    snprintf(needs, sizeof(needs), "needs %s", missing);
+    if (co_await needs_texture || strcmp(asset_failure(needs_texture.id), needs) != 0) {
+        check_result = "a model with the missing texture did not fail naming it";
+        co_return;
+    }
+    if (!co_await good) {
+        check_result = "a model of good parts failed";
+        co_return;
+    }
+    check_result = "";
+}
+
+/* ================= MAIN ================= */
+
+/* FNV-1a over the raw pose bits: identical runs must match bit for bit. */
+static uint32_t pose_checksum(const SceneSnapshot *s) {
+    uint32_t h = 2166136261u;
+    for (int f = 0; f < SNAP_POSE_COUNT; f++) {
+        const unsigned char *b = (const unsigned char *) s->pose[f];
+        for (size_t i = 0; i < sizeof(float) * s->count; i++)
+            h = (h ^ b[i]) * 16777619u;
+    }
+    return h;
+}
+
+/* The same over every world matrix of the character transform tree. */
+static uint32_t world_checksum(const TransformTree *t) {
+    uint32_t h = 2166136261u;
+    const unsigned char *b = (const unsigned char *) t->world;
+    for (size_t i = 0; i < sizeof(float) * 16 * t->count; i++)
+        h = (h ^ b[i]) * 16777619u;
+    return h;
+}
+
+static const char USAGE[] =
+        "usage: u3d_bench [frames] [--es2] [--no-ext] [--agents N] [--hz N] [--paced] [--threads]\n"
+        "                 [--jobs N] [--shader-cache DIR] [--link-polls N] [--textures N]\n"
+        "                 [--upload-budget KB] [--assets DIR] [--asset-threads N]\n"
+        "                 [--ktx2 etc2|astc] [--asset-failures]\n";
+
+int main(int argc, char **argv) {
+    int frames = 2000;
+    int extra_agents = 0;
+    int hz = 60;
+    bool paced = false;
+    int workers = -1;
+    const char *shader_cache = NULL;
+    int textures = 0;
+    int upload_budget = -1;
+    const char *asset_dir = NULL;
+    int asset_threads = -1;
+    const char *ktx2 = NULL;
+    bool asset_failures = false;
+    int status = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--es2") == 0)
+            gl_stub_set_version("OpenGL ES 2.0 u3d-stub");
+        else if (strcmp(argv[i], "--no-ext") == 0)
+            gl_stub_set_extensions("");
+        else if (strcmp(argv[i], "--agents") == 0 && i + 1 < argc)
+            extra_agents = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--hz") == 0 && i + 1 < argc)
+            hz = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--paced") == 0)
+            paced = true;
+        else if (strcmp(argv[i], "--threads") == 0)
+            threaded = paced = true;
+        else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc)
+            workers = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--shader-cache") == 0 && i + 1 < argc)
+            shader_cache = argv[++i];
+        else if (strcmp(argv[i], "--link-polls") == 0 && i + 1 < argc)
+            gl_stub_set_link_polls(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--textures") == 0 && i + 1 < argc)
+            textures = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--upload-budget") == 0 && i + 1 < argc)
+            upload_budget = atoi(argv[++i]) * 1024;
+        else if (strcmp(argv[i], "--assets") == 0 && i + 1 < argc)
+            asset_dir = argv[++i];
+        else if (strcmp(argv[i], "--asset-threads") == 0 && i + 1 < argc)
+            asset_threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--ktx2") == 0 && i + 1 < argc)
+            ktx2 = argv[++i];
+        else if (strcmp(argv[i], "--asset-failures") == 0)
+            asset_failures = true;
+        else if (argv[i][0] && strspn(argv[i], "0123456789") == strlen(argv[i]))
+            frames = atoi(argv[i]);
+        else {
+            fprintf(stderr, "%s", USAGE);
+            return 2;
+        }
+    }
+    if (frames <= 0) frames = 1;
+    if (hz <= 0) hz = 60;
+
+    engine_init(BENCH_WIDTH, BENCH_HEIGHT);
+    jobs_init(workers);
+
+    textures_decode(textures);
+    if (asset_dir && !assets_write(asset_dir, ktx2)) {
+        fprintf(stderr, "cannot write assets to %s\n", asset_dir);
+        return 1;
+    }
+    asset_init(NULL, asset_threads);
+
+    double t0 = now_us();
+    scene_init(shader_cache);
+    if (upload_budget >= 0)
+        texture_set_budget(upload_budget);
+    textures_submit(textures);
+    agents_init();
+    crowd_init(extra_agents);
+    snapshot_publish(0, false);   // lets the input script find the player on frame 0
+    double init_us = now_us() - t0;
+
+    double assets_start = now_us(), assets_us = 0.0;
+    if (asset_dir)
+        assets_load(asset_dir, ktx2);
+    if (asset_dir && asset_failures)
+        assets_check(asset_dir, ktx2);
+
+    Stage stages[] = {
+            {"input", 0, 1e30, 0},
+            {"churn", 0, 1e30, 0},
+            {"sim",   0, 1e30, 0},
+            {"draw",  0, 1e30, 0},
+            {"frame", 0, 1e30, 0},
+    };
+
+    FrameClock clock;
+    if (paced)
+        frame_clock_monotonic(&clock, 1000000000LL / hz);
+    else
+        frame_clock_synthetic(&clock, 1000000000LL / hz);
+
+    Stage late = {"late", 0, 1e30, 0};
+    int sim_steps = 0;
+    int programs_frame = -1;   // first frame drawn with every program linked
+    int textures_frame = -1;   // first frame after which every texture was uploaded
+    int assets_frame = -1;     // first frame after which every asset was ready or failed
+    int idle_frames = 0;   // frames the device loop would not have drawn
+
+    gl_stub_reset_stats();
+    memset(&gl_state_stats, 0, sizeof(gl_state_stats));
+
+    bool fresh;
+    latest = snapshot_acquire(&fresh);
+    if (threaded)
+        sim_thread_start(NULL, NULL);
+
+    for (int f = 0; f < frames; f++) {
+        int64_t frame_ns = clock.wait(&clock);
+        if (paced)
+            stage_add(&late, now_us() - frame_ns * 1e-3);
+
+        /* with --threads the sim thread owns the ECS: no churn, and it ticks itself */
+        double a = now_us();
+        bench_input(f);
+        double b = now_us();
+        if (!threaded) {
+            crowd_churn(f);
+            if (!frame_needed())
+                idle_frames++;
+        }
+        double c = now_us();
+        if (!threaded)
+            sim_steps += frame_tick(frame_ns);
+        double d = now_us();
+        latest = snapshot_acquire(&fresh);
+        scene_draw(latest, snapshot_alpha(latest, frame_ns));
+        double e = now_us();
+        if (programs_frame < 0 && program_stats.pending == 0)
+            programs_frame = f;
+        if (textures_frame < 0 && texture_stats.pending == 0)
+            textures_frame = f;
+        if (assets_frame < 0 && asset_stats.pending == 0) {
+            assets_frame = f;
+            assets_us = now_us() - assets_start;
+        }
+
+        stage_add(&stages[0], b - a);
+        stage_add(&stages[1], c - b);
+        stage_add(&stages[2], d - c);
+        stage_add(&stages[3], e - d);
+        stage_add(&stages[4], e - a);
+    }
+
+    if (threaded) {
+        sim_thread_stop();
+        sim_steps = (int) snapshot_published();
+    }
+
+    printf("u3d_bench: %d frames at %d Hz (%d sim steps%s), %d agents, ES%d, %d job workers, "
+           "init %.1f us\n",
+           frames, hz, sim_steps, threaded ? " on the sim thread" : "",
+           ecs_count(AGENT_COMPONENTS), gl_caps.es_major, jobs_worker_count(), init_us);
+    printf("%-8s %12s %12s %12s\n", "stage", "avg us", "min us", "max us");
+    for (const Stage &s : stages)
+        printf("%-8s %12.3f %12.3f %12.3f\n", s.name, s.total / frames, s.min, s.max);
+    if (paced)
+        printf("%-8s %12.3f %12.3f %12.3f\n", late.name, late.total / frames, late.min, late.max);
+    printf("idle: %d of %d frames would have been skipped\n", idle_frames, frames);
+
+    printf("gl/frame: %.1f calls, %.1f draws, %.1f state, %.1f uniforms\n",
+           (double) gl_stub_stats.calls / frames,
+           (double) gl_stub_stats.draw_calls / frames,
+           (double) gl_stub_stats.state_calls / frames,
+           (double) gl_stub_stats.uniform_calls / frames);
+    printf("gl state/frame: %.1f issued, %.1f elided\n",
+           (double) gl_state_stats.issued / frames,
+           (double) gl_state_stats.elided / frames);
+    printf("queue (last frame): %d packets, %d program binds, %d mesh binds, "
+           "%d uniforms (%d elided)\n",
+           rq_stats.packets, rq_stats.program_binds, rq_stats.mesh_binds,
+           rq_stats.uniform_uploads, rq_stats.uniforms_elided);
+    printf("cull (last frame): %d of %d objects visible, %d culled\n",
+           cull_stats.visible, cull_stats.tested, cull_stats.culled);
+    printf("ui (last frame): %d lines in %d vertices\n", ui_stats.lines, ui_stats.vertices);
+    printf("programs: %d built, %d from cached binaries, %d rejected, %d stored, %d failed; "
+           "all ready by frame %d%s\n",
+           program_stats.programs, program_stats.cached, program_stats.rejected,
+           program_stats.stored, program_stats.failed, programs_frame,
+           gl_caps.parallel_compile ? "" : " (no parallel compile)");
+    printf("textures: %d in %.1f MB, %.1f MB uploaded, all ready by frame %d, "
+           "peak %.1f KB/frame%s\n",
+           texture_stats.textures, texture_stats.memory / (1024.0 * 1024.0),
+           texture_stats.bytes / (1024.0 * 1024.0), textures_frame,
+           texture_stats.peak_frame_bytes / 1024.0,
+           gl_caps.pixel_buffers ? " via pixel buffers" : "");
+    if (asset_dir)
+        printf("assets: %d (%d failed), %.1f MB read, all ready by frame %d (%.1f ms), "
+               "%d/%d models awaited; %d loader threads spent %.1f ms reading + %.1f ms "
+               "decoding\n",
+               asset_stats.assets, asset_stats.failed, asset_stats.bytes / (1024.0 * 1024.0),
+               assets_frame, assets_us * 1e-3, models_ready, BENCH_MODELS,
+               asset_stats.threads, asset_stats.read_us * 1e-3, asset_stats.decode_us * 1e-3);
+    if (asset_stats.failed)
+        printf("asset error: %s\n", asset_error);
+    if (asset_dir && asset_failures) {
+        /* the frames may have ended first; settle the rest here, as the next frames would: the
+         * program links only through program_poll */
+        struct timespec ms = {0, 1000000};
+        for (int i = 0; !check_result && i < 10000; i++) {
+            program_poll();
+            asset_poll();
+            texture_pump();
+            nanosleep(&ms, NULL);
+        }
+        if (!check_result)
+            check_result = "still loading after 10 s";
+        printf("asset failures: %s%s\n", check_result[0] ? "FAILED: " : "ok", check_result);
+        status = check_result[0] ? 1 : 0;
+    }
+    printf("meshes: %d, %d vertices at %.1f B/vertex + %.1f KB indices "
+           "(unpacked: %d vertices at %.1f B/vertex), %.1f KB total (was %.1f KB)\n",
+           mesh_stats.meshes, mesh_stats.vertices,
+           (double) mesh_stats.vertex_bytes / mesh_stats.vertices,
+           mesh_stats.index_bytes / 1024.0, mesh_stats.source_vertices,
+           (double) mesh_stats.source_bytes / mesh_stats.source_vertices,
+           (mesh_stats.vertex_bytes + mesh_stats.index_bytes) / 1024.0,
+           mesh_stats.source_bytes / 1024.0);
+    if (!paced)
+        printf("pose checksum: %08x, world checksum: %08x\n", pose_checksum(latest),
+               world_checksum(scene_character_transforms()));
+
+    bench_math();
+    bench_spatial();
+    bench_pick();
+    asset_shutdown();
+    jobs_shutdown();
+    return status;
+}
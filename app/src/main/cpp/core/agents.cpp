@@ -0,0 +1,197 @@
+#include "agents.h"
+#include "engine.h"
+#include "jobs.h"
+#include "simd.h"
+#include "spatial.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+Entity agent_spawn(float x, float y, float z) {
+    Entity e = ecs_create(AGENT_COMPONENTS);
+    int row;
+    EcsChunk *c = ecs_chunk_of(e, &row);
+    if (!c)
+        return ENTITY_NONE;
+
+    c->field[FIELD_X][row] = c->field[FIELD_PREV_X][row] = x;
+    c->field[FIELD_Y][row] = c->field[FIELD_PREV_Y][row] = y;
+    c->field[FIELD_Z][row] = c->field[FIELD_PREV_Z][row] = z;
+
+    c->field[FIELD_HEIGHT][row] = 1.0f;
+    c->field[FIELD_WIDTH][row]  = 1.0f;
+    c->field[FIELD_DEPTH][row]  = 1.0f;
+    c->field[FIELD_R][row] = 0.8f;
+    c->field[FIELD_G][row] = 0.8f;
+    c->field[FIELD_B][row] = 0.8f;
+
+    spatial_update(e, x, y, z);
+    return e;
+}
+
+void agent_destroy(Entity e) {
+    spatial_remove(e);
+    ecs_destroy(e);
+}
+
+static void set_procedural(Entity e, float height, float width, float depth,
+                           float r, float g, float b, float anim_phase) {
+    int row;
+    EcsChunk *c = ecs_chunk_of(e, &row);
+    if (!c)
+        return;
+
+    c->field[FIELD_HEIGHT][row] = height;
+    c->field[FIELD_WIDTH][row]  = width;
+    c->field[FIELD_DEPTH][row]  = depth;
+    c->field[FIELD_R][row] = r;
+    c->field[FIELD_G][row] = g;
+    c->field[FIELD_B][row] = b;
+    c->field[FIELD_ANIM_PHASE][row] = anim_phase;
+}
+
+void agents_init() {
+    Entity a0 = agent_spawn(-1.3f, 0.0f, 0.0f);
+    Entity a1 = agent_spawn( 1.3f, 0.0f, 0.0f);
+
+    /* ===== PROCEDURAL CHARACTER SETUP ===== */
+    set_procedural(a0, 1.4f, 0.7f, 0.6f, 0.9f, 0.3f, 0.3f, 0.0f);
+    set_procedural(a1, 0.9f, 1.0f, 1.0f, 0.3f, 0.8f, 1.0f, 1.6f);
+
+    engine.player = a0;
+}
+
+void agent_snap_history(Entity e) {
+    int row;
+    EcsChunk *c = ecs_chunk_of(e, &row);
+    if (!c || !c->field[FIELD_PREV_X])
+        return;
+
+    c->field[FIELD_PREV_X][row] = c->field[FIELD_X][row];
+    c->field[FIELD_PREV_Y][row] = c->field[FIELD_Y][row];
+    c->field[FIELD_PREV_Z][row] = c->field[FIELD_Z][row];
+}
+
+/* ================= HISTORY SYSTEM =================
+ * Copies the pose columns before the step changes them; the renderer blends prev -> current.
+ */
+
+static void history_system(EcsChunk *c) {
+    size_t bytes = sizeof(float) * c->count;
+    memcpy(c->field[FIELD_PREV_X], c->field[FIELD_X], bytes);
+    memcpy(c->field[FIELD_PREV_Y], c->field[FIELD_Y], bytes);
+    memcpy(c->field[FIELD_PREV_Z], c->field[FIELD_Z], bytes);
+    if (c->field[FIELD_ROT])
+        memcpy(c->field[FIELD_PREV_ROT], c->field[FIELD_ROT], bytes);
+}
+
+/* ================= SPIN SYSTEM =================
+ * rot += rot_vel, then angular damping, then tiny drift is snapped to rest. Four rows per
+ * step; the columns are ECS_CHUNK_ROWS long so the last partial group runs over scratch rows.
+ */
+
+static bool spin_system(EcsChunk *c) {
+    float *rot = c->field[FIELD_ROT];
+    float *vel = c->field[FIELD_ROT_VEL];
+
+    f4 damp = f4_splat(ROT_DAMP);
+    f4 rest = f4_splat(ROT_REST);
+    f4 speed = f4_splat(0.0f);   // max |rot_vel| seen, per lane
+
+    for (int i = 0; i < c->count; i += 4) {
+        f4 v = f4_load(vel + i);
+        f4_store(rot + i, f4_add(f4_load(rot + i), v));
+        speed = f4_max(speed, f4_abs(v));
+
+        v = f4_mul(v, damp);
+        v = f4_and(v, f4_ge(f4_abs(v), rest));   // kill tiny drift
+        f4_store(vel + i, v);
+    }
+
+    float lanes[4];
+    f4_store(lanes, speed);
+    return lanes[0] > 0.0f || lanes[1] > 0.0f || lanes[2] > 0.0f || lanes[3] > 0.0f;
+}
+
+/* ================= STEP =================
+ * history -> { spin, player move }. Spin and the move write disjoint columns (rot vs x/z), so
+ * once history has copied the old pose they run side by side; spin fans out one chunk per job.
+ * Each chunk reports its own motion and the flags are OR-ed, so the result does not depend on
+ * how the chunks were scheduled.
+ */
+
+static EcsChunkList history_chunks, spin_chunks;
+static bool *chunk_moved;
+static int   chunk_moved_capacity;
+static bool  player_moved;
+
+static void history_range(void *, int begin, int end) {
+    for (int i = begin; i < end; i++)
+        history_system(history_chunks.chunk[i]);
+}
+
+static void spin_range(void *, int begin, int end) {
+    for (int i = begin; i < end; i++)
+        chunk_moved[i] = spin_system(spin_chunks.chunk[i]);
+}
+
+static void history_node(void *) {
+    ecs_gather(&history_chunks, COMP_POSITION | COMP_HISTORY);
+    parallel_for(history_chunks.count, 1, history_range, NULL);
+}
+
+static void spin_node(void *) {
+    ecs_gather(&spin_chunks, COMP_SPIN);
+    if (spin_chunks.count > chunk_moved_capacity) {
+        chunk_moved_capacity = spin_chunks.capacity;
+        chunk_moved = (bool *) realloc(chunk_moved, sizeof(bool) * chunk_moved_capacity);
+    }
+    parallel_for(spin_chunks.count, 1, spin_range, NULL);
+}
+
+/* ===== CHARACTER MOVE (LEFT JOYSTICK) ===== */
+static void move_node(void *) {
+    player_moved = false;
+
+    int row;
+    EcsChunk *p = ecs_chunk_of(engine.player, &row); // primary character
+    if (engine.joyL_active && p) {
+        float move_speed = 0.05f;
+
+        float forward_x = sinf(engine.cam_yaw);
+        float forward_z = cosf(engine.cam_yaw);
+
+        float right_x = cosf(engine.cam_yaw);
+        float right_z = -sinf(engine.cam_yaw);
+
+        float *x = &p->field[FIELD_X][row];
+        float *z = &p->field[FIELD_Z][row];
+
+        // Strafe (left / right)
+        *x += right_x * engine.joyL_x * move_speed;
+        *z += right_z * engine.joyL_x * move_speed;
+
+        // Forward / backward
+        *x += forward_x * engine.joyL_y * move_speed;
+        *z += forward_z * engine.joyL_y * move_speed;
+
+        spatial_update(engine.player, *x, p->field[FIELD_Y][row], *z);
+        player_moved = true;
+    }
+}
+
+bool sim_step() {
+    static JobGraph graph;
+    if (graph.count == 0) {
+        int history = job_graph_add(&graph, history_node, NULL);
+        job_graph_depend(&graph, job_graph_add(&graph, spin_node, NULL), history);
+        job_graph_depend(&graph, job_graph_add(&graph, move_node, NULL), history);
+    }
+    job_graph_run(&graph);
+
+    bool moved = player_moved;
+    for (int i = 0; i < spin_chunks.count; i++)
+        moved |= chunk_moved[i];
+    return moved;
+}
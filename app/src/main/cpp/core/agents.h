@@ -0,0 +1,33 @@
+#ifndef U3D_CORE_AGENTS_H
+#define U3D_CORE_AGENTS_H
+
+#include "config.h"
+#include "ecs.h"
+
+/* ================= AGENTS =================
+ * Agents are entities (see ecs.h): position and spin are the hot data the simulation and
+ * renderer stream every frame; shape, colour and anim_phase are procedural parameters.
+ */
+
+#define AGENT_COMPONENTS (COMP_POSITION | COMP_SPIN | COMP_SHAPE | COMP_COLOR | COMP_ANIM | \
+                          COMP_HISTORY)
+
+/* Spawns an agent at (x, y, z) with neutral procedural parameters. */
+Entity agent_spawn(float x, float y, float z);
+
+/* Destroys an agent and drops it from the spatial index. */
+void agent_destroy(Entity e);
+
+/* Places the default characters and makes the first one engine.player. */
+void agents_init();
+
+/* Advances one fixed step (1 / SIM_HZ): saves the pose history, then rotation inertia/damping
+ * for every spinning entity and left-joystick movement of engine.player. Returns whether
+ * anything moved, i.e. whether this step left the scene different from the last one. */
+bool sim_step();
+
+/* Makes e's current position its previous one too, so it is drawn there without interpolating
+ * (used for direct manipulation such as dragging). */
+void agent_snap_history(Entity e);
+
+#endif //U3D_CORE_AGENTS_H
@@ -0,0 +1,818 @@
+#include "asset.h"
+#include "astc.h"
+#include "etc2.h"
+#include "ktx2.h"
+#include "program.h"
+#include "texture.h"
+
+#include <atomic>
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define ASSET_MAX_DEPS 3
+#define PAM_MAX_SIZE   16384   // larger dimensions are a corrupt header
+#define OBJ_MAX_FACE   32      // corners per polygon
+#define FAULT_STRIDE   4096    // the smallest page size
+
+AssetStats asset_stats;
+char asset_error[ASSET_ERROR_SIZE];
+
+enum Stage {
+    STAGE_QUEUED,    // waiting for or on a loader thread
+    STAGE_LOADED,    // loader thread done; error is set if it failed
+    STAGE_WAITING,   // nothing to load: waiting for its dependencies
+    STAGE_LINKING,   // program submitted
+    STAGE_READY,
+    STAGE_FAILED
+};
+
+/* A texture file the upload queue reads levels from in place: mapped, or read into memory. */
+typedef struct {
+    const uint8_t *data;
+    size_t   size;
+    void    *handle;
+    void   (*unmap)(void *handle, const uint8_t *data, size_t size);   // NULL: data is malloc'd
+} File;
+
+typedef struct {
+    int      kind;               // AssetKind
+    std::atomic<int> stage;      // Stage; STAGE_LOADED publishes the loader thread's fields
+    char     path[ASSET_PATH_SIZE];
+    AssetId  deps[ASSET_MAX_DEPS];
+    int      dep_count;
+    bool     mipmaps;
+    const char *const *attribs;
+    int      attrib_count;
+
+    /* filled in by the loader thread */
+    uint8_t *data;               // text: contents; texture: RGBA8 pixels until queued
+    File    *file;               // texture: the KTX2 file image points into, until queued
+    TextureImage image;          // texture: levels in file or data; 0 levels for plain pixels
+    float   *vertices;           // mesh, until uploaded
+    int      vertex_count;
+    int      width, height;
+    char     error[ASSET_ERROR_SIZE];
+
+    /* GL results */
+    GLuint   texture;
+    GLuint   program;
+    Mesh     mesh;
+} Asset;
+
+static const MeshAttrib LAYOUT_MESH[] = {{3, MESH_POSITION}, {3, MESH_NORMAL}, {2, MESH_FLOAT}};
+
+static Asset assets[ASSET_MAX];
+static int   asset_count;
+static int   first_pending;   // every asset below this is ready or failed
+
+/* A continuation registered with asset_wait. */
+typedef struct {
+    AssetId id;
+    void  (*resume)(void *ctx);
+    void  (*cancel)(void *ctx);
+    void   *ctx;
+} Wait;
+
+static Wait *waits;
+static int   wait_count, wait_capacity;
+
+static AssetIo         io;
+static pthread_t       threads[ASSET_THREADS_MAX];
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  queue_wake = PTHREAD_COND_INITIALIZER;
+static int             queue[ASSET_MAX];           // asset indices; each is queued at most once
+static int             queue_head, queue_tail;
+static bool            running;
+static std::atomic<uint64_t> bytes_read, read_us, decode_us;
+
+static uint64_t now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000u + (uint64_t) ts.tv_nsec / 1000u;
+}
+
+/* ================= FILES ================= */
+
+static uint8_t *stdio_read(const char *path, size_t *size) {
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return NULL;
+
+    uint8_t *data = NULL;
+    long length = fseek(f, 0, SEEK_END) == 0 ? ftell(f) : -1;
+    if (length >= 0 && fseek(f, 0, SEEK_SET) == 0) {
+        data = (uint8_t *) malloc((size_t) length + 1);
+        if (fread(data, 1, (size_t) length, f) == (size_t) length) {
+            *size = (size_t) length;
+        } else {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(f);
+    return data;
+}
+
+static const uint8_t *posix_map(const char *path, size_t *size, void **handle) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+
+    void *data = MAP_FAILED;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        data = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        *size = (size_t) st.st_size;
+    }
+    close(fd);
+    *handle = NULL;
+    return data != MAP_FAILED ? (const uint8_t *) data : NULL;
+}
+
+static void posix_unmap(void *, const uint8_t *data, size_t size) {
+    munmap((void *) data, size);
+}
+
+/* Maps path (or reads it, without io.map) and faults every page in here on the loader thread, so
+ * texture_pump's copies out of it never wait on storage. */
+static File *open_file(const char *path) {
+    File file = {};
+    if (io.map && io.unmap) {
+        file.data = io.map(path, &file.size, &file.handle);
+        file.unmap = io.unmap;
+    } else {
+        file.data = io.read(path, &file.size);
+    }
+    if (!file.data)
+        return NULL;
+
+    uint8_t sum = 0;
+    for (size_t i = 0; i < file.size; i += FAULT_STRIDE)
+        sum ^= file.data[i];
+    volatile uint8_t sink = sum;   // keeps the reads
+    (void) sink;
+
+    File *f = (File *) malloc(sizeof(File));
+    *f = file;
+    return f;
+}
+
+/* Also the upload queue's release callback for the levels of a file. */
+static void close_file(void *ctx) {
+    File *f = (File *) ctx;
+    if (f->unmap)
+        f->unmap(f->handle, f->data, f->size);
+    else
+        free((void *) f->data);
+    free(f);
+}
+
+/* Netpbm PAM: "P7", then WIDTH, HEIGHT, DEPTH, MAXVAL (and optionally TUPLTYPE) lines up to
+ * ENDHDR, then rows of DEPTH bytes per texel. RGB (depth 3) and RGBA (depth 4) at maxval 255. */
+static uint8_t *decode_pam(const uint8_t *data, size_t size, int *width, int *height) {
+    if (size < 3 || memcmp(data, "P7\n", 3) != 0)
+        return NULL;
+
+    const char *p = (const char *) data + 3, *end = (const char *) data + size;
+    int w = 0, h = 0, depth = 0, maxval = 0;
+    for (;;) {
+        const char *eol = (const char *) memchr(p, '\n', (size_t) (end - p));
+        if (!eol)
+            return NULL;
+        char line[64];
+        size_t n = (size_t) (eol - p) < sizeof(line) - 1 ? (size_t) (eol - p) : sizeof(line) - 1;
+        memcpy(line, p, n);
+        line[n] = '\0';
+        p = eol + 1;
+        if (!strcmp(line, "ENDHDR"))
+            break;
+        sscanf(line, "WIDTH %d", &w);
+        sscanf(line, "HEIGHT %d", &h);
+        sscanf(line, "DEPTH %d", &depth);
+        sscanf(line, "MAXVAL %d", &maxval);
+    }
+    if (w <= 0 || h <= 0 || w > PAM_MAX_SIZE || h > PAM_MAX_SIZE ||
+        (depth != 3 && depth != 4) || maxval != 255)
+        return NULL;
+
+    size_t texels = (size_t) w * (size_t) h;
+    if ((size_t) (end - p) < texels * depth)
+        return NULL;
+    uint8_t *rgba = (uint8_t *) malloc(texels * 4);
+    const uint8_t *src = (const uint8_t *) p;
+    if (depth == 4) {
+        memcpy(rgba, src, texels * 4);
+    } else {
+        for (size_t i = 0; i < texels; i++) {
+            rgba[i * 4 + 0] = src[i * 3 + 0];
+            rgba[i * 4 + 1] = src[i * 3 + 1];
+            rgba[i * 4 + 2] = src[i * 3 + 2];
+            rgba[i * 4 + 3] = 255;
+        }
+    }
+    *width = w;
+    *height = h;
+    return rgba;
+}
+
+/* ================= OBJ =================
+ * The subset exporters write for static meshes: v, vt, vn and f. Polygons are fanned into
+ * triangles and negative indices count back from the latest element; everything else (groups,
+ * materials, smoothing) is skipped.
+ */
+
+typedef struct {
+    float *v;
+    int    count, capacity;   // floats
+} FloatList;
+
+static void list_push(FloatList *l, const float *v, int n) {
+    if (l->count + n > l->capacity) {
+        l->capacity = l->capacity ? l->capacity * 2 : 256;
+        if (l->capacity < l->count + n)
+            l->capacity = l->count + n;
+        l->v = (float *) realloc(l->v, sizeof(float) * l->capacity);
+    }
+    memcpy(l->v + l->count, v, sizeof(float) * n);
+    l->count += n;
+}
+
+/* 1-based or negative OBJ index into a list of count elements; -1 if absent or out of range. */
+static int obj_index(long i, int count) {
+    long k = i > 0 ? i - 1 : count + i;
+    return i != 0 && k >= 0 && k < count ? (int) k : -1;
+}
+
+/* Parses one "f" line into corner indices (position, uv, normal; 0 = absent). Returns the
+ * corner count, or 0 if the line is malformed. */
+static int obj_face(const char *p, long corner[OBJ_MAX_FACE][3]) {
+    int n = 0;
+    for (;;) {
+        while (*p == ' ' || *p == '\t')
+            p++;
+        if (*p == '\0' || *p == '\r')
+            return n;
+        if (n == OBJ_MAX_FACE)
+            return 0;
+
+        char *e;
+        long *c = corner[n++];
+        c[0] = strtol(p, &e, 10);
+        c[1] = c[2] = 0;
+        if (e == p)
+            return 0;
+        p = e;
+        if (*p == '/') {
+            c[1] = strtol(++p, &e, 10);
+            p = e;
+            if (*p == '/') {
+                c[2] = strtol(++p, &e, 10);
+                p = e;
+            }
+        }
+    }
+}
+
+static void face_normal(const float *a, const float *b, const float *c, float *n) {
+    float u[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    float v[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    n[0] = u[1] * v[2] - u[2] * v[1];
+    n[1] = u[2] * v[0] - u[0] * v[2];
+    n[2] = u[0] * v[1] - u[1] * v[0];
+    float len = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    float s = len > 0.0f ? 1.0f / len : 0.0f;
+    n[0] *= s;
+    n[1] *= s;
+    n[2] *= s;
+}
+
+/* Emits one triangle of pos(3) normal(3) uv(2) vertices. False if an index is out of range. */
+static bool obj_triangle(FloatList *out, const FloatList *pos, const FloatList *uv,
+                         const FloatList *nrm, long *const corner[3]) {
+    const float *p[3], *t[3], *n[3];
+    bool flat = false;
+    for (int k = 0; k < 3; k++) {
+        int pi = obj_index(corner[k][0], pos->count / 3);
+        if (pi < 0)
+            return false;
+        int ti = obj_index(corner[k][1], uv->count / 2);
+        int ni = obj_index(corner[k][2], nrm->count / 3);
+        if ((corner[k][1] && ti < 0) || (corner[k][2] && ni < 0))
+            return false;
+        p[k] = pos->v + pi * 3;
+        t[k] = ti >= 0 ? uv->v + ti * 2 : NULL;
+        n[k] = ni >= 0 ? nrm->v + ni * 3 : NULL;
+        flat |= n[k] == NULL;
+    }
+
+    float fn[3];
+    if (flat)
+        face_normal(p[0], p[1], p[2], fn);
+    for (int k = 0; k < 3; k++) {
+        const float *normal = flat ? fn : n[k];
+        float v[8] = {p[k][0], p[k][1], p[k][2], normal[0], normal[1], normal[2],
+                      t[k] ? t[k][0] : 0.0f, t[k] ? t[k][1] : 0.0f};
+        list_push(out, v, 8);
+    }
+    return true;
+}
+
+/* Parses text (modified in place) into a->vertices, or sets a->error. */
+static void decode_obj(Asset *a, char *text) {
+    FloatList pos = {}, uv = {}, nrm = {}, out = {};
+    int line_no = 0;
+    for (char *line = text, *next; line && !a->error[0]; line = next) {
+        next = strchr(line, '\n');
+        if (next)
+            *next++ = '\0';
+        line_no++;
+
+        float v[3];
+        if (!strncmp(line, "v ", 2) && sscanf(line + 2, "%f %f %f", &v[0], &v[1], &v[2]) == 3) {
+            list_push(&pos, v, 3);
+        } else if (!strncmp(line, "vt ", 3) && sscanf(line + 3, "%f %f", &v[0], &v[1]) == 2) {
+            list_push(&uv, v, 2);
+        } else if (!strncmp(line, "vn ", 3) &&
+                   sscanf(line + 3, "%f %f %f", &v[0], &v[1], &v[2]) == 3) {
+            list_push(&nrm, v, 3);
+        } else if (!strncmp(line, "f ", 2)) {
+            long corner[OBJ_MAX_FACE][3];
+            int n = obj_face(line + 2, corner);
+            bool ok = n >= 3;
+            for (int i = 1; ok && i + 1 < n; i++) {
+                long *const tri[3] = {corner[0], corner[i], corner[i + 1]};
+                ok = obj_triangle(&out, &pos, &uv, &nrm, tri);
+            }
+            if (!ok)
+                snprintf(a->error, sizeof(a->error), "bad face on line %d", line_no);
+        }
+    }
+    if (!a->error[0] && out.count == 0)
+        snprintf(a->error, sizeof(a->error), "no faces");
+
+    free(pos.v);
+    free(uv.v);
+    free(nrm.v);
+    if (a->error[0]) {
+        free(out.v);
+        return;
+    }
+    a->vertices = out.v;
+    a->vertex_count = out.count / 8;
+}
+
+/* ================= TEXTURES ================= */
+
+/* Decodes every level of a's compressed image with decode_level into one RGBA8 chain in
+ * a->data, sRGB if the image was. */
+static void decode_rgba8(Asset *a, bool srgb,
+                         void (*decode_level)(const TextureImage *, int, uint8_t *)) {
+    TextureImage rgba = a->image;
+    rgba.internal_format = srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+    rgba.block_width = rgba.block_height = 1;
+    rgba.block_bytes = 4;
+
+    size_t offset[TEXTURE_MAX_LEVELS], total = 0;
+    for (int level = 0; level < rgba.levels; level++) {
+        offset[level] = total;
+        total += texture_level_size(&rgba, level);
+    }
+    a->data = (uint8_t *) malloc(total);
+    for (int level = 0; level < rgba.levels; level++) {
+        decode_level(&a->image, level, a->data + offset[level]);
+        rgba.level[level] = a->data + offset[level];
+    }
+    a->image = rgba;
+}
+
+/* Turns a's file into something texture.h takes. A KTX2 file in a format the context samples
+ * is kept in a->file with a->image pointing into it; anything else is decoded into a->data and
+ * the file closed. */
+static void decode_texture(Asset *a, File *file) {
+    if (ktx2_is(file->data, file->size)) {
+        if (ktx2_parse(file->data, file->size, &a->image, a->error, sizeof(a->error))) {
+            if (ktx2_supported(&a->image)) {
+                a->file = file;
+                return;
+            }
+            GLenum format = a->image.internal_format;
+            /* the ETC2 sRGB enums are the odd ones, the ASTC ones a second run of 14 */
+            if (etc2_format(format))
+                decode_rgba8(a, (format - GL_COMPRESSED_RGB8_ETC2) & 1, etc2_decode_level);
+            else if (astc_format(format))
+                decode_rgba8(a, format >= GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR,
+                             astc_decode_level);
+            else
+                snprintf(a->error, sizeof(a->error), "%s textures are not supported here",
+                         ktx2_format_name(a->image.internal_format));
+        }
+    } else {
+        a->data = decode_pam(file->data, file->size, &a->width, &a->height);
+        if (!a->data && io.decode_image)
+            a->data = io.decode_image(file->data, file->size, &a->width, &a->height);
+        if (!a->data)
+            snprintf(a->error, sizeof(a->error), "not an image this platform decodes");
+    }
+    close_file(file);
+}
+
+/* ================= LOADER THREADS ================= */
+
+/* Reads and decodes a's file. Runs on a loader thread (or inline without any). */
+static void load(Asset *a) {
+    uint64_t t0 = now_us();
+    size_t size = 0;
+    uint8_t *data = NULL;
+    File *file = NULL;
+    if (a->kind == ASSET_TEXTURE) {
+        file = open_file(a->path);
+        size = file ? file->size : 0;
+    } else {
+        data = io.read(a->path, &size);
+    }
+    uint64_t t1 = now_us();
+
+    if (!data && !file) {
+        snprintf(a->error, sizeof(a->error), "cannot read");
+    } else if (file) {
+        decode_texture(a, file);
+    } else {
+        /* text, or OBJ parsed as text */
+        data = (uint8_t *) realloc(data, size + 1);
+        data[size] = '\0';
+        if (a->kind == ASSET_MESH) {
+            decode_obj(a, (char *) data);
+            free(data);
+        } else {
+            a->data = data;
+        }
+    }
+
+    bytes_read.fetch_add(size, std::memory_order_relaxed);
+    read_us.fetch_add(t1 - t0, std::memory_order_relaxed);
+    decode_us.fetch_add(now_us() - t1, std::memory_order_relaxed);
+    a->stage.store(STAGE_LOADED, std::memory_order_release);
+}
+
+static void *loader_main(void *) {
+    pthread_mutex_lock(&queue_lock);
+    for (;;) {
+        while (running && queue_head == queue_tail)
+            pthread_cond_wait(&queue_wake, &queue_lock);
+        if (!running)
+            break;
+        Asset *a = &assets[queue[queue_head++]];
+        pthread_mutex_unlock(&queue_lock);
+        load(a);
+        pthread_mutex_lock(&queue_lock);
+    }
+    pthread_mutex_unlock(&queue_lock);
+    return NULL;
+}
+
+void asset_init(const AssetIo *platform, int thread_count) {
+    io.read = platform && platform->read ? platform->read : stdio_read;
+    io.decode_image = platform ? platform->decode_image : NULL;
+    io.map = platform ? platform->map : posix_map;
+    io.unmap = platform ? platform->unmap : posix_unmap;
+    memset(&asset_stats, 0, sizeof(asset_stats));
+    asset_error[0] = '\0';
+    bytes_read = read_us = decode_us = 0;
+    asset_count = first_pending = 0;
+    queue_head = queue_tail = 0;
+
+    if (thread_count < 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = cores > 0 ? (int) cores : 1;
+    }
+    if (thread_count > ASSET_THREADS_MAX)
+        thread_count = ASSET_THREADS_MAX;
+
+    running = true;
+    for (int i = 0; i < thread_count; i++)
+        if (pthread_create(&threads[asset_stats.threads], NULL, loader_main, NULL) == 0)
+            asset_stats.threads++;
+}
+
+void asset_shutdown() {
+    pthread_mutex_lock(&queue_lock);
+    running = false;
+    pthread_cond_broadcast(&queue_wake);
+    pthread_mutex_unlock(&queue_lock);
+    for (int i = 0; i < asset_stats.threads; i++)
+        pthread_join(threads[i], NULL);
+    asset_stats.threads = 0;
+
+    for (int i = 0; i < asset_count; i++) {
+        free(assets[i].data);
+        free(assets[i].vertices);
+        if (assets[i].file)
+            close_file(assets[i].file);
+    }
+    asset_count = first_pending = 0;
+
+    /* a cancel may free what registered further waits, but may not register any */
+    for (int i = 0; i < wait_count; i++)
+        waits[i].cancel(waits[i].ctx);
+    wait_count = 0;
+}
+
+/* ================= REQUESTS ================= */
+
+static AssetId add(int kind, const char *path, int stage) {
+    if (asset_count == ASSET_MAX || strlen(path) >= ASSET_PATH_SIZE) {
+        snprintf(asset_error, sizeof(asset_error), "%.128s: %s", path,
+                 asset_count == ASSET_MAX ? "too many assets" : "path too long");
+        asset_stats.failed++;
+        return 0;
+    }
+    Asset *a = &assets[asset_count++];
+    a->kind = kind;
+    a->stage.store(stage, std::memory_order_relaxed);
+    snprintf(a->path, sizeof(a->path), "%s", path);
+    a->dep_count = 0;
+    a->mipmaps = false;
+    a->attribs = NULL;
+    a->attrib_count = 0;
+    a->data = NULL;
+    a->file = NULL;
+    memset(&a->image, 0, sizeof(a->image));
+    a->vertices = NULL;
+    a->vertex_count = a->width = a->height = 0;
+    a->error[0] = '\0';
+    a->texture = a->program = 0;
+    memset(&a->mesh, 0, sizeof(a->mesh));
+
+    asset_stats.assets++;
+    asset_stats.pending++;
+    return asset_count;
+}
+
+static AssetId load_file(int kind, const char *path, bool mipmaps) {
+    for (int i = 0; i < asset_count; i++)
+        if (assets[i].kind == kind && !strcmp(assets[i].path, path))
+            return i + 1;
+
+    AssetId id = add(kind, path, STAGE_QUEUED);
+    if (!id)
+        return 0;
+    assets[id - 1].mipmaps = mipmaps;
+    if (asset_stats.threads == 0) {
+        load(&assets[id - 1]);
+        return id;
+    }
+    pthread_mutex_lock(&queue_lock);
+    queue[queue_tail++] = id - 1;
+    pthread_cond_signal(&queue_wake);
+    pthread_mutex_unlock(&queue_lock);
+    return id;
+}
+
+AssetId asset_load_text(const char *path) {
+    return load_file(ASSET_TEXT, path, false);
+}
+
+AssetId asset_load_texture(const char *path, bool mipmaps) {
+    return load_file(ASSET_TEXTURE, path, mipmaps);
+}
+
+AssetId asset_load_mesh(const char *path) {
+    return load_file(ASSET_MESH, path, false);
+}
+
+AssetId asset_load_program(const char *vs_path, const char *fs_path,
+                           const char *const *attribs, int attrib_count) {
+    AssetId vs = asset_load_text(vs_path), fs = asset_load_text(fs_path);
+    for (int i = 0; i < asset_count; i++) {
+        const Asset *a = &assets[i];
+        if (a->kind == ASSET_PROGRAM && a->deps[0] == vs && a->deps[1] == fs &&
+            a->attribs == attribs && a->attrib_count == attrib_count)
+            return i + 1;
+    }
+
+    char name[ASSET_PATH_SIZE];
+    snprintf(name, sizeof(name), "%.120s + %.120s", vs_path, fs_path);
+    AssetId id = add(ASSET_PROGRAM, name, STAGE_WAITING);
+    if (!id)
+        return 0;
+    Asset *a = &assets[id - 1];
+    a->deps[0] = vs;
+    a->deps[1] = fs;
+    a->dep_count = 2;
+    a->attribs = attribs;
+    a->attrib_count = attrib_count;
+    return id;
+}
+
+AssetId asset_load_model(const char *mesh_path, const char *texture_path, AssetId program) {
+    AssetId mesh = asset_load_mesh(mesh_path);
+    AssetId texture = asset_load_texture(texture_path, true);
+    char name[ASSET_PATH_SIZE];
+    snprintf(name, sizeof(name), "%.120s + %.120s", mesh_path, texture_path);
+    AssetId id = add(ASSET_MODEL, name, STAGE_WAITING);
+    if (!id)
+        return 0;
+    Asset *a = &assets[id - 1];
+    a->deps[0] = mesh;
+    a->deps[1] = texture;
+    a->deps[2] = program;
+    a->dep_count = 3;
+    return id;
+}
+
+/* ================= GL THREAD ================= */
+
+static void fail(Asset *a, const char *reason) {
+    if (reason != a->error)
+        snprintf(a->error, sizeof(a->error), "%s", reason);
+    snprintf(asset_error, sizeof(asset_error), "%.128s: %.120s", a->path, a->error);
+    free(a->data);
+    free(a->vertices);
+    if (a->file)
+        close_file(a->file);
+    a->data = NULL;
+    a->vertices = NULL;
+    a->file = NULL;
+    a->stage.store(STAGE_FAILED, std::memory_order_relaxed);
+    asset_stats.pending--;
+    asset_stats.failed++;
+}
+
+static void ready(Asset *a) {
+    a->stage.store(STAGE_READY, std::memory_order_relaxed);
+    asset_stats.pending--;
+}
+
+/* Whether every dependency is ready. Fails a if one has failed. Dependencies always have lower
+ * ids, so asset_poll has already settled them this round. */
+static bool deps_ready(Asset *a) {
+    for (int i = 0; i < a->dep_count; i++) {
+        const Asset *d = a->deps[i] ? &assets[a->deps[i] - 1] : NULL;
+        int stage = d ? d->stage.load(std::memory_order_acquire) : STAGE_FAILED;
+        if (stage == STAGE_FAILED) {
+            char reason[ASSET_ERROR_SIZE];
+            snprintf(reason, sizeof(reason), "needs %.200s", d ? d->path : "an invalid asset");
+            fail(a, reason);
+            return false;
+        }
+        if (stage != STAGE_READY)
+            return false;
+    }
+    return true;
+}
+
+static void advance(Asset *a, int stage) {
+    if (stage == STAGE_LOADED && a->error[0]) {
+        fail(a, a->error);
+        return;
+    }
+    if (stage == STAGE_LINKING) {
+        if (program_ready(a->program))
+            ready(a);
+        else if (program_failed(a->program))
+            fail(a, program_error);
+        return;
+    }
+    if (!deps_ready(a))
+        return;
+
+    switch (a->kind) {
+        case ASSET_TEXTURE:
+            /* the upload queue owns the pixels or the file now */
+            if (a->file)
+                a->texture = texture_submit_image(&a->image, close_file, a->file);
+            else if (a->image.levels)
+                a->texture = texture_submit_image(&a->image, free, a->data);
+            else
+                a->texture = texture_submit(a->data, a->width, a->height, a->mipmaps);
+            a->data = NULL;
+            a->file = NULL;
+            if (!a->texture) {
+                fail(a, "texture upload queue full");
+                return;
+            }
+            break;
+        case ASSET_MESH: {
+            bool uploaded = mesh_upload(&a->mesh, GL_TRIANGLES, a->vertices, a->vertex_count,
+                                        LAYOUT_MESH, 3);
+            free(a->vertices);
+            a->vertices = NULL;
+            if (!uploaded) {
+                fail(a, "no vertices");
+                return;
+            }
+            break;
+        }
+        case ASSET_PROGRAM:
+            a->program = program_submit((const char *) assets[a->deps[0] - 1].data,
+                                        (const char *) assets[a->deps[1] - 1].data,
+                                        a->attribs, a->attrib_count, NULL);
+            if (!a->program)
+                fail(a, program_error);
+            else
+                a->stage.store(STAGE_LINKING, std::memory_order_relaxed);
+            return;
+        default:
+            break;   // text is complete once read; a model only waits for its parts
+    }
+    ready(a);
+}
+
+void asset_poll() {
+    int first = -1;
+    for (int i = first_pending; i < asset_count; i++) {
+        Asset *a = &assets[i];
+        int stage = a->stage.load(std::memory_order_acquire);
+        if (stage != STAGE_QUEUED && stage != STAGE_READY && stage != STAGE_FAILED) {
+            advance(a, stage);
+            stage = a->stage.load(std::memory_order_relaxed);
+        }
+        if (first < 0 && stage != STAGE_READY && stage != STAGE_FAILED)
+            first = i;
+    }
+    first_pending = first < 0 ? asset_count : first;
+
+    /* resume may register waits of its own; those are appended and looked at in this pass too */
+    for (int i = 0; i < wait_count;) {
+        Wait w = waits[i];
+        if (asset_state(w.id) == ASSET_LOADING) {
+            i++;
+            continue;
+        }
+        memmove(&waits[i], &waits[i + 1], sizeof(Wait) * (wait_count - i - 1));
+        wait_count--;
+        w.resume(w.ctx);
+    }
+
+    asset_stats.bytes = bytes_read.load(std::memory_order_relaxed);
+    asset_stats.read_us = read_us.load(std::memory_order_relaxed);
+    asset_stats.decode_us = decode_us.load(std::memory_order_relaxed);
+}
+
+void asset_wait(AssetId id, void (*resume)(void *ctx), void (*cancel)(void *ctx), void *ctx) {
+    if (wait_count == wait_capacity) {
+        wait_capacity = wait_capacity ? wait_capacity * 2 : 64;
+        waits = (Wait *) realloc(waits, sizeof(Wait) * wait_capacity);
+    }
+    waits[wait_count++] = {id, resume, cancel, ctx};
+}
+
+/* ================= RESULTS ================= */
+
+static const Asset *get(AssetId id) {
+    return id > 0 && id <= asset_count ? &assets[id - 1] : NULL;
+}
+
+static bool is_ready(const Asset *a) {
+    return a && a->stage.load(std::memory_order_acquire) == STAGE_READY;
+}
+
+int asset_state(AssetId id) {
+    const Asset *a = get(id);
+    int stage = a ? a->stage.load(std::memory_order_acquire) : STAGE_FAILED;
+    return stage == STAGE_READY ? ASSET_READY : stage == STAGE_FAILED ? ASSET_FAILED
+                                                                      : ASSET_LOADING;
+}
+
+const char *asset_failure(AssetId id) {
+    const Asset *a = get(id);
+    if (!a)
+        return "no such asset";
+    return a->stage.load(std::memory_order_acquire) == STAGE_FAILED ? a->error : "";
+}
+
+/* A model's part, or the asset itself. */
+static const Asset *part(AssetId id, int kind, int dep) {
+    const Asset *a = get(id);
+    if (a && a->kind == ASSET_MODEL)
+        a = is_ready(a) ? get(a->deps[dep]) : NULL;
+    return is_ready(a) && a->kind == kind ? a : NULL;
+}
+
+const char *asset_text(AssetId id) {
+    const Asset *a = part(id, ASSET_TEXT, 0);
+    return a ? (const char *) a->data : NULL;
+}
+
+GLuint asset_texture(AssetId id) {
+    const Asset *a = part(id, ASSET_TEXTURE, 1);
+    return texture_resolve(a ? a->texture : 0);
+}
+
+const Mesh *asset_mesh(AssetId id) {
+    const Asset *a = part(id, ASSET_MESH, 0);
+    return a ? &a->mesh : NULL;
+}
+
+GLuint asset_program(AssetId id) {
+    const Asset *a = part(id, ASSET_PROGRAM, 2);
+    return a ? a->program : 0;
+}
@@ -0,0 +1,133 @@
+#ifndef U3D_CORE_ASSET_H
+#define U3D_CORE_ASSET_H
+
+#include "gles.h"
+#include "mesh.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ================= ASSETS =================
+ * Loads files in the background and turns them into GL objects on the GL thread. Every
+ * asset_load_* call returns an id at once. Assets that come from a file are read and decoded
+ * on a pool of loader threads (file I/O blocks, so these are not the job workers); asset_poll,
+ * called once per frame on the GL thread, then runs the GL half of each finished asset:
+ *   ASSET_TEXT     NUL-terminated file contents (shader sources); no GL half
+ *   ASSET_TEXTURE  KTX2 (ktx2.h) with its stored mip chain, uploaded straight from the mapped
+ *                  file, or a PAM image (or whatever AssetIo.decode_image knows), queued on
+ *                  texture.h
+ *   ASSET_MESH     Wavefront OBJ triangles, uploaded with mesh_upload
+ *   ASSET_PROGRAM  two text assets, built with program_submit; ready once linked
+ *   ASSET_MODEL    a mesh, a texture and a program; ready once all three are
+ * An asset waits for the assets it depends on, and fails with a message naming the dependency
+ * if one of them fails, so a model never half-appears. Loading the same file (or the same pair
+ * of shaders) twice returns the first id, so shared dependencies are read once.
+ *
+ * A texture asset is ready as soon as its pixels are queued; asset_texture hands out the
+ * upload queue's placeholder until they have streamed in. Assets live until asset_shutdown.
+ *
+ * asset_wait registers a continuation that asset_poll runs once an asset has settled; it is
+ * what the co_await layer in asset_task.h resumes coroutines with.
+ *
+ * asset_load_*, asset_wait, asset_poll and the accessors belong to the GL thread.
+ */
+
+#define ASSET_MAX         1024
+#define ASSET_THREADS_MAX 8
+#define ASSET_PATH_SIZE   256
+#define ASSET_ERROR_SIZE  256
+
+enum AssetKind {
+    ASSET_TEXT,
+    ASSET_TEXTURE,
+    ASSET_MESH,
+    ASSET_PROGRAM,
+    ASSET_MODEL
+};
+
+enum AssetState {
+    ASSET_LOADING,
+    ASSET_READY,
+    ASSET_FAILED
+};
+
+typedef int AssetId;   // 0 = none
+
+/* Platform file access, called on the loader threads (so all must be thread-safe). */
+typedef struct {
+    /* The whole file at path in a malloc'd buffer, or NULL if it cannot be read. */
+    uint8_t *(*read)(const char *path, size_t *size);
+    /* Decodes an image that is not PAM into malloc'd, tightly packed RGBA8 rows. NULL if the
+     * format is unknown or the data is broken. May be NULL itself. */
+    uint8_t *(*decode_image)(const uint8_t *data, size_t size, int *width, int *height);
+    /* The whole file at path mapped read-only, with whatever unmap needs in *handle; NULL if it
+     * cannot be mapped. Texture files are mapped so KTX2 levels reach GL without a copy; unmap
+     * may then run on the GL thread, once the upload queue is done with them. Both NULL: texture
+     * files are read like the rest. */
+    const uint8_t *(*map)(const char *path, size_t *size, void **handle);
+    void (*unmap)(void *handle, const uint8_t *data, size_t size);
+} AssetIo;
+
+typedef struct {
+    int      assets;     // ids handed out
+    int      pending;    // neither ready nor failed
+    int      failed;
+    int      threads;    // loader threads
+    uint64_t bytes;      // read from files
+    uint64_t read_us;    // loader thread time spent reading, summed over threads
+    uint64_t decode_us;  // and decoding
+} AssetStats;
+
+extern AssetStats asset_stats;
+
+/* Message of the most recent failure, "path: reason", "" if none. */
+extern char asset_error[ASSET_ERROR_SIZE];
+
+/* Starts threads loader threads (< 0: one per online core, up to ASSET_THREADS_MAX). io NULL
+ * reads paths with stdio, maps them with mmap and decodes only PAM and KTX2 images. */
+void asset_init(const AssetIo *io, int threads);
+
+/* Stops the loader threads and forgets every asset (its GL objects are left to the context). */
+void asset_shutdown();
+
+AssetId asset_load_text(const char *path);
+
+/* mipmaps as for texture_submit; a repeated request keeps the first one's. A KTX2 file keeps the
+ * chain it was stored with. ETC2 or ASTC files the context cannot sample (ES2, or ASTC without
+ * the extension) are decoded to RGBA8 on the loader thread. */
+AssetId asset_load_texture(const char *path, bool mipmaps);
+
+/* Positions, normals and texture coordinates at locations 0, 1 and 2; faces without normals get
+ * flat ones, and missing texture coordinates are 0. */
+AssetId asset_load_mesh(const char *path);
+
+/* attribs as for program_submit, and likewise must outlive the asset. */
+AssetId asset_load_program(const char *vs_path, const char *fs_path,
+                           const char *const *attribs, int attrib_count);
+
+AssetId asset_load_model(const char *mesh_path, const char *texture_path, AssetId program);
+
+/* Runs the GL half of every asset whose data and dependencies are ready, then the waits on
+ * every asset that is now ready or failed, in the order they were registered; call once per
+ * frame. */
+void asset_poll();
+
+/* Calls resume(ctx) from asset_poll once id is ready or failed (from the next asset_poll even if
+ * it already is). asset_shutdown calls cancel(ctx) instead for waits still registered. resume
+ * may load and wait on more assets. */
+void asset_wait(AssetId id, void (*resume)(void *ctx), void (*cancel)(void *ctx), void *ctx);
+
+int asset_state(AssetId id);   // AssetState
+
+/* Why the asset failed, e.g. "bad face on line 3" or "needs <path>" for a dependency; "" unless
+ * it has. Unlike asset_error, not overwritten by later failures. */
+const char *asset_failure(AssetId id);
+
+/* The asset's own results; 0/NULL unless it is ready (asset_texture: the placeholder). For a
+ * model these are its mesh's, texture's and program's. */
+const char *asset_text(AssetId id);
+GLuint      asset_texture(AssetId id);
+const Mesh *asset_mesh(AssetId id);
+GLuint      asset_program(AssetId id);
+
+#endif //U3D_CORE_ASSET_H
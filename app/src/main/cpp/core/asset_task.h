@@ -0,0 +1,133 @@
+#ifndef U3D_CORE_ASSET_TASK_H
+#define U3D_CORE_ASSET_TASK_H
+
+#include "asset.h"
+
+#include <coroutine>
+#include <exception>
+
+/* ================= ASSET COROUTINES =================
+ * co_await on top of asset.h. load<T>(...) starts loading at once and returns an awaitable; a
+ * coroutine returning AssetTask awaits it and is resumed by asset_poll, on the GL thread, once
+ * the asset is ready or failed. Reading and decoding still happen on the loader threads, so
+ * only the code after each co_await runs where GL is current:
+ *
+ *     static AssetTask load_crate() {
+ *         auto mesh = load<Mesh>("crate.obj");           // both start loading here
+ *         auto texture = load<AssetTexture>("crate.ktx2");
+ *         const Mesh *m = co_await mesh;
+ *         AssetTexture t = co_await texture;
+ *         if (!m || !t)
+ *             return;                                      // asset_error says why
+ *         ...
+ *     }
+ *
+ * Start everything before awaiting anything, or the loads run one after another. What each
+ * load<T> takes and what co_await gives back:
+ *   load<AssetText>(path)                         const char *, NULL on failure
+ *   load<AssetTexture>(path, mipmaps = true)      AssetTexture, false on failure
+ *   load<Mesh>(path)                              const Mesh *, NULL on failure
+ *   load<AssetProgram>(vs, fs, attribs, count)    GLuint, 0 on failure
+ *   load<AssetModel>(mesh, texture, program id)   AssetModel, false on failure
+ * Dependencies are asset.h's: a model resumes once its mesh, texture and program are all ready,
+ * or fails as soon as one of them does.
+ *
+ * AssetTask is fire-and-forget: the coroutine owns itself and ends when its body does. One
+ * still suspended at asset_shutdown is destroyed without resuming.
+ */
+
+/* Tags for load<T> whose results are plain values. */
+struct AssetText {};
+struct AssetProgram {};
+
+/* A texture asset. Its GL name is the upload queue's placeholder until every texel has
+ * streamed in, so fetch it every frame rather than keeping it. */
+struct AssetTexture {
+    AssetId id;
+
+    GLuint name() const { return asset_texture(id); }
+    explicit operator bool() const { return asset_state(id) == ASSET_READY; }
+};
+
+/* A model asset's parts. */
+struct AssetModel {
+    AssetId      id;
+    const Mesh  *mesh;
+    AssetTexture texture;
+    GLuint       program;
+
+    explicit operator bool() const { return mesh != NULL; }
+};
+
+/* How each T is started and what its result is. */
+template <typename T> struct AssetType;
+
+template <> struct AssetType<AssetText> {
+    static AssetId start(const char *path) { return asset_load_text(path); }
+    static const char *result(AssetId id) { return asset_text(id); }
+};
+
+template <> struct AssetType<AssetTexture> {
+    static AssetId start(const char *path, bool mipmaps = true) {
+        return asset_load_texture(path, mipmaps);
+    }
+    static AssetTexture result(AssetId id) { return {id}; }
+};
+
+template <> struct AssetType<Mesh> {
+    static AssetId start(const char *path) { return asset_load_mesh(path); }
+    static const Mesh *result(AssetId id) { return asset_mesh(id); }
+};
+
+template <> struct AssetType<AssetProgram> {
+    static AssetId start(const char *vs_path, const char *fs_path, const char *const *attribs,
+                         int attrib_count) {
+        return asset_load_program(vs_path, fs_path, attribs, attrib_count);
+    }
+    static GLuint result(AssetId id) { return asset_program(id); }
+};
+
+template <> struct AssetType<AssetModel> {
+    static AssetId start(const char *mesh_path, const char *texture_path, AssetId program) {
+        return asset_load_model(mesh_path, texture_path, program);
+    }
+    static AssetModel result(AssetId id) {
+        return {id, asset_mesh(id), {id}, asset_program(id)};
+    }
+};
+
+template <typename T>
+struct AssetLoad {
+    AssetId id;
+
+    bool await_ready() const { return asset_state(id) != ASSET_LOADING; }
+
+    void await_suspend(std::coroutine_handle<> waiter) const {
+        asset_wait(id, resume, cancel, waiter.address());
+    }
+
+    auto await_resume() const { return AssetType<T>::result(id); }
+
+private:
+    static void resume(void *ctx) { std::coroutine_handle<>::from_address(ctx).resume(); }
+    static void cancel(void *ctx) { std::coroutine_handle<>::from_address(ctx).destroy(); }
+};
+
+/* Starts loading a T; the asset's id is in .id for asset.h's calls. */
+template <typename T, typename... Args>
+AssetLoad<T> load(Args... args) {
+    return {AssetType<T>::start(args...)};
+}
+
+/* Return type of a coroutine that awaits assets. It runs up to its first co_await at once. */
+struct AssetTask {
+    struct promise_type {
+        AssetTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+#endif //U3D_CORE_ASSET_TASK_H
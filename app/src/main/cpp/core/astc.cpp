@@ -0,0 +1,549 @@
+#include "astc.h"
+
+#include <string.h>
+
+/* Block layouts, tables and formulas follow the Khronos Data Format Specification 1.3, section
+ * 23 (ASTC). Bit numbers below are the specification's: bit 0 is the lowest bit of byte 0. */
+
+#define MAX_TEXELS  144   // 12x12
+#define MAX_WEIGHTS 64
+#define MAX_VALUES  18    // colour endpoint values: four partitions of RGB, or RGBA
+
+/* Integer sequence encoding: each quantization range is trits, quints or neither, times bits. */
+typedef struct {
+    int levels;
+    int trits, quints, bits;
+} Range;
+
+static const Range RANGES[21] = {
+        {2, 0, 0, 1},   {3, 1, 0, 0},   {4, 0, 0, 2},   {5, 0, 1, 0},   {6, 1, 0, 1},
+        {8, 0, 0, 3},   {10, 0, 1, 1},  {12, 1, 0, 2},  {16, 0, 0, 4},  {20, 0, 1, 2},
+        {24, 1, 0, 3},  {32, 0, 0, 5},  {40, 0, 1, 3},  {48, 1, 0, 4},  {64, 0, 0, 6},
+        {80, 0, 1, 4},  {96, 1, 0, 5},  {128, 0, 0, 7}, {160, 0, 1, 5}, {192, 1, 0, 6},
+        {256, 0, 0, 8}};
+
+#define FIRST_COLOR_RANGE 4   // endpoints never use fewer than 6 levels
+
+static const uint8_t ERROR_COLOR[4] = {255, 0, 255, 255};
+
+static int bits(const uint8_t *block, int low, int count) {
+    int v = 0;
+    for (int i = 0; i < count; i++)
+        v |= (block[(low + i) >> 3] >> ((low + i) & 7) & 1) << i;
+    return v;
+}
+
+static int ise_size(const Range *r, int count) {
+    return r->bits * count + (r->trits ? (8 * count + 4) / 5 : r->quints ? (7 * count + 2) / 3 : 0);
+}
+
+/* Reads up to end, and zeros past it: the last trit or quint group may be cut short. */
+typedef struct {
+    const uint8_t *data;
+    int pos, end;
+} Reader;
+
+static int read_bits(Reader *r, int count) {
+    int n = r->pos + count <= r->end ? count : r->end > r->pos ? r->end - r->pos : 0;
+    int v = n ? bits(r->data, r->pos, n) : 0;
+    r->pos += count;
+    return v;
+}
+
+/* 8 bits packing five trits, and 7 bits packing three quints (23.12 and 23.13). */
+static void unpack_trits(int t, int out[5]) {
+    int c;
+    if ((t >> 2 & 7) == 7) {
+        c = (t >> 5 & 7) << 2 | (t & 3);
+        out[4] = out[3] = 2;
+    } else {
+        c = t & 0x1F;
+        if ((t >> 5 & 3) == 3) {
+            out[4] = 2;
+            out[3] = t >> 7 & 1;
+        } else {
+            out[4] = t >> 7 & 1;
+            out[3] = t >> 5 & 3;
+        }
+    }
+    if ((c & 3) == 3) {
+        out[2] = 2;
+        out[1] = c >> 4 & 1;
+        out[0] = (c >> 3 & 1) << 1 | ((c >> 2 & 1) & ~(c >> 3) & 1);
+    } else if ((c >> 2 & 3) == 3) {
+        out[2] = 2;
+        out[1] = 2;
+        out[0] = c & 3;
+    } else {
+        out[2] = c >> 4 & 1;
+        out[1] = c >> 2 & 3;
+        out[0] = (c >> 1 & 1) << 1 | ((c & 1) & ~(c >> 1) & 1);
+    }
+}
+
+static void unpack_quints(int q, int out[3]) {
+    if ((q >> 1 & 3) == 3 && (q >> 5 & 3) == 0) {
+        out[2] = (q & 1) << 2 | ((q >> 4 & 1) & ~q & 1) << 1 | ((q >> 3 & 1) & ~q & 1);
+        out[1] = out[0] = 4;
+        return;
+    }
+    int c;
+    if ((q >> 1 & 3) == 3) {
+        out[2] = 4;
+        c = (q >> 3 & 3) << 3 | (~q >> 5 & 3) << 1 | (q & 1);
+    } else {
+        out[2] = q >> 5 & 3;
+        c = q & 0x1F;
+    }
+    if ((c & 7) == 5) {
+        out[1] = 4;
+        out[0] = c >> 3 & 3;
+    } else {
+        out[1] = c >> 3 & 3;
+        out[0] = c & 7;
+    }
+}
+
+/* count values of range r from r's stream: low bits in bits[], the trit or quint in tq[]. */
+static void ise_decode(Reader *in, const Range *r, int count, int *low, int *tq) {
+    int b = r->bits;
+    for (int i = 0; i < count;) {
+        if (r->trits) {
+            int m[5], t = 0;
+            m[0] = read_bits(in, b), t |= read_bits(in, 2);
+            m[1] = read_bits(in, b), t |= read_bits(in, 2) << 2;
+            m[2] = read_bits(in, b), t |= read_bits(in, 1) << 4;
+            m[3] = read_bits(in, b), t |= read_bits(in, 2) << 5;
+            m[4] = read_bits(in, b), t |= read_bits(in, 1) << 7;
+            int trits[5];
+            unpack_trits(t, trits);
+            for (int k = 0; k < 5 && i < count; k++, i++)
+                low[i] = m[k], tq[i] = trits[k];
+        } else if (r->quints) {
+            int m[3], q = 0;
+            m[0] = read_bits(in, b), q |= read_bits(in, 3);
+            m[1] = read_bits(in, b), q |= read_bits(in, 2) << 3;
+            m[2] = read_bits(in, b), q |= read_bits(in, 2) << 5;
+            int quints[3];
+            unpack_quints(q, quints);
+            for (int k = 0; k < 3 && i < count; k++, i++)
+                low[i] = m[k], tq[i] = quints[k];
+        } else {
+            low[i] = read_bits(in, b), tq[i] = 0;
+            i++;
+        }
+    }
+}
+
+/* v's low bits repeated until they fill to bits. */
+static int replicate(int v, int from, int to) {
+    if (from == 0)
+        return 0;
+    int out = 0, have = 0;
+    while (have < to) {
+        out = out << from | v;
+        have += from;
+    }
+    return out >> (have - to);
+}
+
+/* Colour endpoint values to 0..255 (23.14). */
+static int unquantize_color(const Range *r, int low, int tq) {
+    if (!r->trits && !r->quints)
+        return replicate(low, r->bits, 8);
+    int a = low & 1 ? 0x1FF : 0, h = low >> 1, b, c;
+    if (r->trits) {
+        static const int C[7] = {0, 204, 93, 44, 22, 11, 5};
+        c = C[r->bits];
+        switch (r->bits) {
+            case 1: b = 0; break;
+            case 2: b = h * 0x116; break;
+            case 3: b = h << 7 | h << 2 | h; break;
+            case 4: b = h << 6 | h; break;
+            case 5: b = h << 5 | h >> 2; break;
+            default: b = h << 4 | h >> 4; break;
+        }
+    } else {
+        static const int C[6] = {0, 113, 54, 26, 13, 6};
+        c = C[r->bits];
+        switch (r->bits) {
+            case 1: b = 0; break;
+            case 2: b = h * 0x10C; break;
+            case 3: b = h << 7 | h << 1 | h >> 1; break;
+            case 4: b = h << 6 | h >> 1; break;
+            default: b = h << 5 | h >> 3; break;
+        }
+    }
+    int t = (tq * c + b) ^ a;
+    return (a & 0x80) | t >> 2;
+}
+
+/* Weights to 0..64 (23.17). */
+static int unquantize_weight(const Range *r, int low, int tq) {
+    int w;
+    if (!r->trits && !r->quints) {
+        w = replicate(low, r->bits, 6);
+    } else if (r->bits == 0) {
+        static const int TRITS[3] = {0, 32, 63}, QUINTS[5] = {0, 16, 32, 47, 63};
+        w = r->trits ? TRITS[tq] : QUINTS[tq];
+    } else {
+        int a = low & 1 ? 0x7F : 0, h = low >> 1, b, c;
+        if (r->trits) {
+            c = r->bits == 1 ? 50 : r->bits == 2 ? 23 : 11;
+            b = r->bits == 1 ? 0 : r->bits == 2 ? h * 0x45 : h << 5 | h;
+        } else {
+            c = r->bits == 1 ? 28 : 13;
+            b = r->bits == 1 ? 0 : h * 0x42;
+        }
+        int t = (tq * c + b) ^ a;
+        w = (a & 0x20) | t >> 2;
+    }
+    return w > 32 ? w + 1 : w;
+}
+
+/* ================= ENDPOINTS ================= */
+
+static int clamp(int v) {
+    return v < 0 ? 0 : v > 255 ? 255 : v;
+}
+
+/* b takes a's top bit; a becomes a signed 6-bit offset. */
+static void bit_transfer(int *a, int *b) {
+    *b = *b >> 1 | (*a & 0x80);
+    *a = *a >> 1 & 0x3F;
+    if (*a & 0x20)
+        *a -= 0x40;
+}
+
+static void set_rgba(int *e, int r, int g, int b, int a) {
+    e[0] = clamp(r), e[1] = clamp(g), e[2] = clamp(b), e[3] = clamp(a);
+}
+
+/* The blue-contracted form of an RGB(A) endpoint. */
+static void set_contracted(int *e, int r, int g, int b, int a) {
+    set_rgba(e, (r + b) >> 1, (g + b) >> 1, b, a);
+}
+
+/* Endpoint pair of colour endpoint mode cem from its values (23.15); false for the HDR ones. */
+static bool decode_endpoints(int cem, int *v, int e0[4], int e1[4]) {
+    switch (cem) {
+        case 0:   // luminance
+            set_rgba(e0, v[0], v[0], v[0], 255);
+            set_rgba(e1, v[1], v[1], v[1], 255);
+            return true;
+        case 1: {   // luminance, base + offset
+            int l0 = v[0] >> 2 | (v[1] & 0xC0);
+            int l1 = l0 + (v[1] & 0x3F);
+            set_rgba(e0, l0, l0, l0, 255);
+            set_rgba(e1, l1, l1, l1, 255);
+            return true;
+        }
+        case 4:   // luminance + alpha
+            set_rgba(e0, v[0], v[0], v[0], v[2]);
+            set_rgba(e1, v[1], v[1], v[1], v[3]);
+            return true;
+        case 5:   // luminance + alpha, base + offset
+            bit_transfer(&v[1], &v[0]);
+            bit_transfer(&v[3], &v[2]);
+            set_rgba(e0, v[0], v[0], v[0], v[2]);
+            set_rgba(e1, v[0] + v[1], v[0] + v[1], v[0] + v[1], v[2] + v[3]);
+            return true;
+        case 6:   // RGB, scaled
+            set_rgba(e0, v[0] * v[3] >> 8, v[1] * v[3] >> 8, v[2] * v[3] >> 8, 255);
+            set_rgba(e1, v[0], v[1], v[2], 255);
+            return true;
+        case 10:   // RGB scaled, two alphas
+            set_rgba(e0, v[0] * v[3] >> 8, v[1] * v[3] >> 8, v[2] * v[3] >> 8, v[4]);
+            set_rgba(e1, v[0], v[1], v[2], v[5]);
+            return true;
+        case 8:    // RGB
+        case 12: {   // RGBA
+            int a0 = cem == 12 ? v[6] : 255, a1 = cem == 12 ? v[7] : 255;
+            if (v[1] + v[3] + v[5] >= v[0] + v[2] + v[4]) {
+                set_rgba(e0, v[0], v[2], v[4], a0);
+                set_rgba(e1, v[1], v[3], v[5], a1);
+            } else {
+                set_contracted(e0, v[1], v[3], v[5], a1);
+                set_contracted(e1, v[0], v[2], v[4], a0);
+            }
+            return true;
+        }
+        case 9:    // RGB, base + offset
+        case 13: {   // RGBA, base + offset
+            int pairs = cem == 13 ? 4 : 3;
+            for (int k = 0; k < pairs; k++)
+                bit_transfer(&v[2 * k + 1], &v[2 * k]);
+            int a0 = cem == 13 ? v[6] : 255, a1 = cem == 13 ? v[6] + v[7] : 255;
+            if (v[1] + v[3] + v[5] >= 0) {
+                set_rgba(e0, v[0], v[2], v[4], a0);
+                set_rgba(e1, v[0] + v[1], v[2] + v[3], v[4] + v[5], a1);
+            } else {
+                set_contracted(e0, v[0] + v[1], v[2] + v[3], v[4] + v[5], a1);
+                set_contracted(e1, v[0], v[2], v[4], a0);
+            }
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+/* ================= BLOCKS ================= */
+
+/* The partition a texel falls in (23.21). */
+static int partition_of(int seed, int x, int y, int count, bool small) {
+    if (small)
+        x <<= 1, y <<= 1;
+    seed += (count - 1) * 1024;
+    uint32_t r = (uint32_t) seed;
+    r ^= r >> 15;
+    r -= r << 17;
+    r += r << 7;
+    r += r << 4;
+    r ^= r >> 5;
+    r += r << 16;
+    r ^= r >> 7;
+    r ^= r >> 3;
+    r ^= r << 6;
+    r ^= r >> 17;
+
+    int s[8];
+    for (int i = 0; i < 8; i++) {
+        int v = (int) (r >> 4 * i & 0xF);
+        s[i] = v * v;
+    }
+    int sh1, sh2;
+    if (seed & 1) {
+        sh1 = seed & 2 ? 4 : 5;
+        sh2 = count == 3 ? 6 : 5;
+    } else {
+        sh1 = count == 3 ? 6 : 5;
+        sh2 = seed & 2 ? 4 : 5;
+    }
+    for (int i = 0; i < 8; i++)
+        s[i] >>= i & 1 ? sh2 : sh1;
+
+    int a = (s[0] * x + s[1] * y + (int) (r >> 14)) & 0x3F;
+    int b = (s[2] * x + s[3] * y + (int) (r >> 10)) & 0x3F;
+    int c = count < 3 ? 0 : (s[4] * x + s[5] * y + (int) (r >> 6)) & 0x3F;
+    int d = count < 4 ? 0 : (s[6] * x + s[7] * y + (int) (r >> 2)) & 0x3F;
+    if (a >= b && a >= c && a >= d)
+        return 0;
+    if (b >= c && b >= d)
+        return 1;
+    return c >= d ? 2 : 3;
+}
+
+/* Weight grid size, range and planes of a block mode (23.10); false if reserved. */
+static bool block_mode(int mode, int *grid_w, int *grid_h, int *range, bool *dual) {
+    int r, a = mode >> 5 & 3, b = mode >> 7 & 3;
+    bool high = mode >> 9 & 1;
+    *dual = mode >> 10 & 1;
+    if (mode & 3) {
+        r = (mode & 3) << 1 | (mode >> 4 & 1);
+        switch (mode >> 2 & 3) {
+            case 0: *grid_w = b + 4, *grid_h = a + 2; break;
+            case 1: *grid_w = b + 8, *grid_h = a + 2; break;
+            case 2: *grid_w = a + 2, *grid_h = b + 8; break;
+            default:
+                if (mode >> 8 & 1)
+                    *grid_w = (b & 1) + 2, *grid_h = a + 2;
+                else
+                    *grid_w = a + 2, *grid_h = (b & 1) + 6;
+                break;
+        }
+    } else {
+        r = (mode >> 2 & 3) << 1 | (mode >> 4 & 1);
+        if ((mode & 0xF) == 0)
+            return false;
+        switch (b) {
+            case 0: *grid_w = 12, *grid_h = a + 2; break;
+            case 1: *grid_w = a + 2, *grid_h = 12; break;
+            case 2:
+                *grid_w = a + 6, *grid_h = (mode >> 9 & 3) + 6;
+                high = *dual = false;
+                break;
+            default:
+                if (a == 0)
+                    *grid_w = 6, *grid_h = 10;
+                else if (a == 1)
+                    *grid_w = 10, *grid_h = 6;
+                else
+                    return false;
+                break;
+        }
+    }
+    *range = r - 2 + (high ? 6 : 0);
+    return r >= 2;
+}
+
+/* One block into bw x bh RGBA texels, row-major; false if it is an error block. sRGB endpoints
+ * widen to 16 bits with 0x80 below them rather than a copy of themselves (23.19), alpha too. */
+static bool decode_block(const uint8_t *block, int bw, int bh, bool srgb, uint8_t out[][4]) {
+    int mode = bits(block, 0, 11);
+    if ((mode & 0x1FF) == 0x1FC) {
+        /* void extent: one colour, as four UNORM16. HDR ones are not LDR, and the extent must be
+         * all ones or not empty */
+        if (mode & 0x200)
+            return false;
+        int s0 = bits(block, 12, 13), s1 = bits(block, 25, 13);
+        int t0 = bits(block, 38, 13), t1 = bits(block, 51, 13);
+        bool all_ones = s0 == 0x1FFF && s1 == 0x1FFF && t0 == 0x1FFF && t1 == 0x1FFF;
+        if (!all_ones && (s0 >= s1 || t0 >= t1))
+            return false;
+        for (int k = 0; k < 4; k++) {
+            uint8_t c = (uint8_t) (bits(block, 64 + 16 * k, 16) >> 8);
+            for (int i = 0; i < bw * bh; i++)
+                out[i][k] = c;
+        }
+        return true;
+    }
+
+    int grid_w, grid_h, range;
+    bool dual;
+    if (!block_mode(mode, &grid_w, &grid_h, &range, &dual) || grid_w > bw || grid_h > bh)
+        return false;
+    const Range *weight_range = &RANGES[range];
+    int weight_count = grid_w * grid_h * (dual ? 2 : 1);
+    int weight_bits = ise_size(weight_range, weight_count);
+    if (weight_count > MAX_WEIGHTS || weight_bits < 24 || weight_bits > 96)
+        return false;
+
+    int partitions = bits(block, 11, 2) + 1;
+    if (partitions == 4 && dual)
+        return false;
+
+    /* colour endpoint modes; with several partitions, some of their bits sit below the weights */
+    int cem[4], below = 128 - weight_bits, color_start;
+    if (partitions == 1) {
+        cem[0] = bits(block, 13, 4);
+        color_start = 17;
+    } else {
+        int field = bits(block, 23, 6);
+        color_start = 29;
+        if ((field & 3) == 0) {
+            for (int p = 0; p < partitions; p++)
+                cem[p] = field >> 2;
+        } else {
+            int extra = 3 * partitions - 4;
+            below -= extra;
+            int encoded = field | bits(block, below, extra) << 6;
+            int base = (field & 3) - 1;
+            for (int p = 0; p < partitions; p++) {
+                cem[p] = (base + (encoded >> (2 + p) & 1)) << 2 |
+                         (encoded >> (2 + partitions + 2 * p) & 3);
+            }
+        }
+    }
+    int plane2 = -1;
+    if (dual) {
+        below -= 2;
+        plane2 = bits(block, below, 2);
+    }
+
+    int value_count = 0;
+    for (int p = 0; p < partitions; p++)
+        value_count += ((cem[p] >> 2) + 1) * 2;
+    int color_bits = below - color_start;
+    if (value_count > MAX_VALUES || color_bits < (13 * value_count + 4) / 5)
+        return false;
+    int color_range = 20;
+    while (ise_size(&RANGES[color_range], value_count) > color_bits)
+        color_range--;
+    if (color_range < FIRST_COLOR_RANGE)
+        return false;
+
+    int low[MAX_WEIGHTS], tq[MAX_WEIGHTS], values[MAX_VALUES];
+    Reader colors = {block, color_start, color_start + ise_size(&RANGES[color_range], value_count)};
+    ise_decode(&colors, &RANGES[color_range], value_count, low, tq);
+    for (int i = 0; i < value_count; i++)
+        values[i] = unquantize_color(&RANGES[color_range], low[i], tq[i]);
+
+    /* a partition with HDR endpoints is the error colour, the others still decode */
+    int e0[4][4], e1[4][4];
+    bool ldr[4];
+    for (int p = 0, v = 0; p < partitions; v += ((cem[p] >> 2) + 1) * 2, p++)
+        ldr[p] = decode_endpoints(cem[p], values + v, e0[p], e1[p]);
+
+    /* weights run from bit 127 downwards */
+    uint8_t reversed[16];
+    for (int i = 0; i < 16; i++) {
+        uint8_t v = block[15 - i], r = 0;
+        for (int k = 0; k < 8; k++)
+            r |= (uint8_t) ((v >> k & 1) << (7 - k));
+        reversed[i] = r;
+    }
+    int weights[MAX_WEIGHTS];
+    Reader weight_reader = {reversed, 0, weight_bits};
+    ise_decode(&weight_reader, weight_range, weight_count, low, tq);
+    for (int i = 0; i < weight_count; i++)
+        weights[i] = unquantize_weight(weight_range, low[i], tq[i]);
+
+    /* the grid is resampled to the block's texels (23.18) */
+    int seed = bits(block, 13, 10);
+    bool small = bw * bh < 31;
+    int ds = (1024 + bw / 2) / (bw - 1), dt = (1024 + bh / 2) / (bh - 1);
+    int planes = dual ? 2 : 1;
+    for (int y = 0; y < bh; y++) {
+        for (int x = 0; x < bw; x++) {
+            int gs = (ds * x * (grid_w - 1) + 32) >> 6, gt = (dt * y * (grid_h - 1) + 32) >> 6;
+            int js = gs >> 4, fs = gs & 0xF, jt = gt >> 4, ft = gt & 0xF;
+            int w11 = (fs * ft + 8) >> 4, w10 = ft - w11, w01 = fs - w11;
+            int w00 = 16 - fs - ft + w11;
+            int s1 = js + 1 < grid_w ? 1 : 0, t1 = jt + 1 < grid_h ? grid_w : 0;
+            int i00 = js + jt * grid_w;
+
+            int w[2];
+            for (int k = 0; k < planes; k++) {
+                const int *g = weights + k;
+                w[k] = (g[i00 * planes] * w00 + g[(i00 + s1) * planes] * w01 +
+                        g[(i00 + t1) * planes] * w10 + g[(i00 + s1 + t1) * planes] * w11 + 8) >>
+                       4;
+            }
+
+            int p = partitions > 1 ? partition_of(seed, x, y, partitions, small) : 0;
+            uint8_t *texel = out[y * bw + x];
+            if (!ldr[p]) {
+                memcpy(texel, ERROR_COLOR, 4);
+                continue;
+            }
+            for (int k = 0; k < 4; k++) {
+                int weight = k == plane2 ? w[1] : w[0];
+                int c0 = e0[p][k] << 8 | (srgb ? 0x80 : e0[p][k]);
+                int c1 = e1[p][k] << 8 | (srgb ? 0x80 : e1[p][k]);
+                texel[k] = (uint8_t) ((c0 * (64 - weight) + c1 * weight + 32) >> 6 >> 8);
+            }
+        }
+    }
+    return true;
+}
+
+bool astc_format(GLenum internal_format) {
+    return (internal_format >= GL_COMPRESSED_RGBA_ASTC_4x4_KHR &&
+            internal_format < GL_COMPRESSED_RGBA_ASTC_4x4_KHR + 14) ||
+           (internal_format >= GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR &&
+            internal_format < GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR + 14);
+}
+
+void astc_decode_level(const TextureImage *image, int level, uint8_t *rgba) {
+    int bw = image->block_width, bh = image->block_height;
+    int width = image->width >> level > 0 ? image->width >> level : 1;
+    int height = image->height >> level > 0 ? image->height >> level : 1;
+
+    bool srgb = image->internal_format >= GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR;
+    const uint8_t *src = image->level[level];
+    for (int by = 0; by < height; by += bh) {
+        for (int bx = 0; bx < width; bx += bw) {
+            uint8_t texels[MAX_TEXELS][4];
+            if (!decode_block(src, bw, bh, srgb, texels))
+                for (int i = 0; i < bw * bh; i++)
+                    memcpy(texels[i], ERROR_COLOR, 4);
+            src += image->block_bytes;
+
+            /* the last column and row of blocks may hang over the edge */
+            for (int y = 0; y < bh && by + y < height; y++)
+                for (int x = 0; x < bw && bx + x < width; x++)
+                    memcpy(rgba + ((size_t) (by + y) * width + bx + x) * 4, texels[y * bw + x], 4);
+        }
+    }
+}
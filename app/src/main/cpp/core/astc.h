@@ -0,0 +1,27 @@
+#ifndef U3D_CORE_ASTC_H
+#define U3D_CORE_ASTC_H
+
+#include "texture.h"
+
+#include <stdint.h>
+
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR         0x93B0   // 13 more footprints follow each
+#define GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR 0x93D0
+#endif
+
+/* ================= ASTC =================
+ * CPU decoder for ASTC LDR: 2D blocks of every footprint from 4x4 to 12x12, UNORM and sRGB, as
+ * KHR_texture_compression_astc_ldr defines them; sRGB texels stay encoded, as with ETC2. Like
+ * etc2.h it is only for contexts that cannot sample ASTC (ES2, and ES3 devices without the
+ * extension), and it restores 4 bytes per texel. Blocks the LDR profile cannot decode (HDR
+ * endpoints, reserved encodings) come out magenta, the specification's error colour.
+ */
+
+/* Whether astc_decode_level handles internal_format. */
+bool astc_format(GLenum internal_format);
+
+/* Decodes one level of image into tightly packed RGBA8 rows of its width x height. */
+void astc_decode_level(const TextureImage *image, int level, uint8_t *rgba);
+
+#endif //U3D_CORE_ASTC_H
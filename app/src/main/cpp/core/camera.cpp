@@ -0,0 +1,36 @@
+#include "camera.h"
+#include "config.h"
+#include "engine.h"
+#include "mat4.h"
+
+FrameConstants frame_constants;
+
+void frame_constants_build(FrameConstants *fc, const Engine *e) {
+    /* projection only changes with the surface aspect */
+    float aspect = (float)e->width / (float)e->height;
+    if (aspect != fc->aspect) {
+        fc->aspect = aspect;
+        mat4_perspective(fc->proj, CAM_FOV, aspect, CAM_NEAR, CAM_FAR);
+        mat4_inverse(fc->inv_proj, fc->proj);
+    }
+
+    float ry[16], rx[16], rot[16];
+    mat4_rotate_y(ry, e->cam_yaw);
+    mat4_rotate_x(rx, e->cam_pitch);
+    mat4_mul_affine(rot, rx, ry);
+    mat4_translate(fc->view, e->cam_x, e->cam_y, e->cam_z);
+    mat4_mul_affine(fc->view, fc->view, rot);
+
+    mat4_mul(fc->view_proj, fc->proj, fc->view);
+
+    mat4_inverse_affine(fc->inv_view, fc->view);
+    mat4_inverse(fc->inv_view_proj, fc->view_proj);
+
+    fc->eye[0] = fc->inv_view[12];
+    fc->eye[1] = fc->inv_view[13];
+    fc->eye[2] = fc->inv_view[14];
+}
+
+void frame_constants_update() {
+    frame_constants_build(&frame_constants, &engine);
+}
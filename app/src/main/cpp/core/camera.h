@@ -0,0 +1,34 @@
+#ifndef U3D_CORE_CAMERA_H
+#define U3D_CORE_CAMERA_H
+
+/* ================= FRAME CONSTANTS =================
+ * Everything derived from the camera that stays fixed for a frame. Built once at the top of the
+ * frame; draws only upload view_proj (once per program) plus their own model matrix.
+ */
+
+typedef struct {
+    float view[16];
+    float proj[16];
+    float view_proj[16];
+    float inv_view[16];
+    float inv_proj[16];
+    float inv_view_proj[16];
+
+    float eye[3];             // camera position in world space
+
+    float aspect;             // aspect the current proj was built for
+} FrameConstants;
+
+struct Engine;
+
+/* The simulation side's frame constants (input picking). The renderer builds its own from each
+ * snapshot's engine copy. */
+extern FrameConstants frame_constants;
+
+/* Rebuilds fc from e's camera pose and surface size. */
+void frame_constants_build(FrameConstants *fc, const Engine *e);
+
+/* frame_constants_build(&frame_constants, &engine). */
+void frame_constants_update();
+
+#endif //U3D_CORE_CAMERA_H
@@ -0,0 +1,43 @@
+#include "character.h"
+#include "mat4.h"
+
+#include <math.h>
+
+/* translate(tx, ty, tz) * scale(sx, sy, sz) */
+#define PART(tx, ty, tz, sx, sy, sz) { sx, 0, 0, 0,  0, sy, 0, 0,  0, 0, sz, 0,  tx, ty, tz, 1 }
+
+const float body_part_local[BODY_PARTS][16] = {
+        PART( 0.0f,  0.6f, 0.0f,  0.9f,  1.2f, 0.5f),    // torso
+        PART(-0.8f,  0.7f, 0.0f,  0.25f, 0.9f, 0.25f),   // left arm: upper torso height, thin and long
+        PART( 0.8f,  0.7f, 0.0f,  0.25f, 0.9f, 0.25f),   // right arm
+        PART( 0.0f,  1.5f, 0.0f,  0.5f,  0.5f, 0.5f),    // head
+        PART(-0.3f, -0.3f, 0.0f,  0.3f,  0.8f, 0.3f),    // left leg
+        PART( 0.3f, -0.3f, 0.0f,  0.3f,  0.8f, 0.3f),    // right leg
+};
+
+#undef PART
+
+void character_part_matrices(float *out, float x, float y, float z, float rot) {
+    float root_rot[16];
+    mat4_translate_rotate_y(root_rot, x, y, z, rot);
+    mat4_mul_affine_many(out, root_rot, &body_part_local[0][0], BODY_PARTS);
+}
+
+void character_bounds(float *radius, float *y_min, float *y_max) {
+    float r2 = 0.0f, lo = 0.0f, hi = 0.0f;
+    for (int p = 0; p < BODY_PARTS; p++) {
+        const float *m = body_part_local[p];
+        /* unit cube: half extents are half the scale */
+        float ax = fabsf(m[12]) + m[0] * 0.5f;
+        float az = fabsf(m[14]) + m[10] * 0.5f;
+        float y0 = m[13] - m[5] * 0.5f;
+        float y1 = m[13] + m[5] * 0.5f;
+
+        if (ax * ax + az * az > r2) r2 = ax * ax + az * az;
+        if (p == 0 || y0 < lo) lo = y0;
+        if (p == 0 || y1 > hi) hi = y1;
+    }
+    *radius = sqrtf(r2);
+    *y_min = lo;
+    *y_max = hi;
+}
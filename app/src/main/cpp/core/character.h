@@ -0,0 +1,34 @@
+#ifndef U3D_CORE_CHARACTER_H
+#define U3D_CORE_CHARACTER_H
+
+#include "ecs.h"
+
+/* ================= CHARACTER =================
+ * A character is BODY_PARTS unit cubes placed relative to its root. Each part's local
+ * translate*scale is constant, so a part's model matrix is root_rot * body_part_local[p].
+ */
+
+#define BODY_PARTS 6
+
+/* Every entity with a position and a spin is drawn (and picked) as a character. */
+#define CHARACTER_COMPONENTS (COMP_POSITION | COMP_SPIN)
+
+enum BodyPartId {
+    PART_TORSO,
+    PART_LEFT_ARM,
+    PART_RIGHT_ARM,
+    PART_HEAD,
+    PART_LEFT_LEG,
+    PART_RIGHT_LEG
+};
+
+extern const float body_part_local[BODY_PARTS][16];
+
+/* Writes BODY_PARTS model matrices (16 floats apart) for a character at (x, y, z) facing rot. */
+void character_part_matrices(float *out, float x, float y, float z, float rot);
+
+/* Bounds of all parts relative to the root that hold for any rot: the parts fit in a vertical
+ * cylinder of the given radius spanning [y_min, y_max]. */
+void character_bounds(float *radius, float *y_min, float *y_max);
+
+#endif //U3D_CORE_CHARACTER_H
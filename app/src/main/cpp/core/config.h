@@ -0,0 +1,47 @@
+#ifndef U3D_CORE_CONFIG_H
+#define U3D_CORE_CONFIG_H
+
+/* ================= SIMULATION ================= */
+
+#define PICK_RADIUS 0.9f   // selection ring radius
+
+#define ROT_SENS 0.005f
+#define ROT_DAMP 0.82f
+#define ROT_REST 0.0005f   // |rot_vel| below this snaps to 0
+#define SIM_HZ        60   // fixed simulation rate; ROT_DAMP and move speeds are per step
+#define SIM_STEP_NS   (1000000000LL / SIM_HZ)
+#define SIM_MAX_STEPS 4    // cap on catch-up steps after a stall
+
+/* ================= CAMERA ================= */
+
+#define CAM_FOV   1.35f   // ~77 degrees (wide-angle)
+#define CAM_NEAR  0.1f
+#define CAM_FAR   50.0f
+
+/* ================= UI LAYOUT (NDC) ================= */
+
+#define JOY_RADIUS   0.25f   // size in NDC
+#define JOY_Y_OFFSET -0.75f  // bottom of screen
+#define JOY_LEFT_X  -0.6f
+#define JOY_RIGHT_X  0.6f
+#define LOCK_Y  0.85f
+#define LOCK_SPACING 0.18f
+#define LOCK_SIZE 0.06f
+#define CAM_LOCK_START_X  -0.3f
+#define OBJ_LOCK_START_X   0.3f
+#define AXIS_BTN_RADIUS   0.06f
+#define AXIS_BTN_SPACING  0.15f
+#define AXIS_BTN_Y        -0.85f
+#define AXIS_BTN_START_X  0.55f
+#define AXIS_BTN_SEGMENTS 32
+#define THUMB_RADIUS 0.06f
+#define THUMB_SEGMENTS 32
+
+/* ================= WORLD ================= */
+
+#define GRID_STEP     1.0f    // minor line spacing
+#define GRID_MAJOR    10.0f   // major line spacing, a multiple of GRID_STEP
+#define SEL_SEGMENTS 64
+#define SPATIAL_CELL  2.0f    // spatial index cell edge, ~2x a character's footprint
+
+#endif //U3D_CORE_CONFIG_H
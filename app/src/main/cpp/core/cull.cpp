@@ -0,0 +1,78 @@
+#include "cull.h"
+#include "simd.h"
+
+#include <math.h>
+
+CullStats cull_stats;
+
+/* Row i of a column-major matrix is (m[i], m[4 + i], m[8 + i], m[12 + i]); each plane is row 3
+ * plus or minus one of rows 0..2. */
+void frustum_from_matrix(Frustum *f, const float *m) {
+    for (int p = 0; p < 6; p++) {
+        int row = p / 2;
+        float sign = (p & 1) ? -1.0f : 1.0f;   // left/right, bottom/top, near/far
+        float *pl = f->plane[p];
+        for (int c = 0; c < 4; c++)
+            pl[c] = m[c * 4 + 3] + sign * m[c * 4 + row];
+
+        float len = sqrtf(pl[0] * pl[0] + pl[1] * pl[1] + pl[2] * pl[2]);
+        if (len > 0.0f)
+            for (int c = 0; c < 4; c++)
+                pl[c] /= len;
+    }
+}
+
+bool frustum_test_sphere(const Frustum *f, float x, float y, float z, float r) {
+    for (int p = 0; p < 6; p++) {
+        const float *pl = f->plane[p];
+        if (pl[0] * x + pl[1] * y + pl[2] * z + pl[3] < -r)
+            return false;
+    }
+    return true;
+}
+
+/* Only the corner furthest along each plane's normal needs testing. */
+bool frustum_test_aabb(const Frustum *f, const float lo[3], const float hi[3]) {
+    for (int p = 0; p < 6; p++) {
+        const float *pl = f->plane[p];
+        float x = pl[0] >= 0.0f ? hi[0] : lo[0];
+        float y = pl[1] >= 0.0f ? hi[1] : lo[1];
+        float z = pl[2] >= 0.0f ? hi[2] : lo[2];
+        if (pl[0] * x + pl[1] * y + pl[2] * z + pl[3] < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+/* Per lane: the smallest signed distance over all planes, plus r. A lane is visible when that
+ * is still >= 0. */
+int frustum_test_spheres(const Frustum *f, const float *x, const float *y, const float *z,
+                         float r, int count, uint8_t *visible) {
+    f4 a[6], b[6], c[6], d[6];
+    for (int p = 0; p < 6; p++) {
+        a[p] = f4_splat(f->plane[p][0]);
+        b[p] = f4_splat(f->plane[p][1]);
+        c[p] = f4_splat(f->plane[p][2]);
+        d[p] = f4_splat(f->plane[p][3] + r);
+    }
+
+    int n = 0, i = 0;
+    for (; i + 4 <= count; i += 4) {
+        f4 px = f4_load(x + i), py = f4_load(y + i), pz = f4_load(z + i);
+        f4 margin = f4_madd(a[0], px, f4_madd(b[0], py, f4_madd(c[0], pz, d[0])));
+        for (int p = 1; p < 6; p++)
+            margin = f4_min(margin, f4_madd(a[p], px, f4_madd(b[p], py, f4_madd(c[p], pz, d[p]))));
+
+        float lanes[4];
+        f4_store(lanes, margin);
+        for (int k = 0; k < 4; k++) {
+            visible[i + k] = lanes[k] >= 0.0f;
+            n += visible[i + k];
+        }
+    }
+    for (; i < count; i++) {
+        visible[i] = frustum_test_sphere(f, x[i], y[i], z[i], r);
+        n += visible[i];
+    }
+    return n;
+}
@@ -0,0 +1,36 @@
+#ifndef U3D_CORE_CULL_H
+#define U3D_CORE_CULL_H
+
+#include <stdint.h>
+
+/* ================= FRUSTUM CULLING =================
+ * The six clip planes of a view-projection matrix (Gribb/Hartmann extraction), normalized so
+ * plane distances are in world units. A bound is kept unless it lies entirely outside one
+ * plane, so the test is conservative: near frustum corners a few invisible objects survive,
+ * but nothing visible is ever dropped.
+ */
+
+typedef struct {
+    float plane[6][4];   // (a, b, c, d): a point is inside when a*x + b*y + c*z + d >= 0
+} Frustum;
+
+/* Counts for the last drawn frame, filled in by the scene. */
+typedef struct {
+    int tested;
+    int visible;
+    int culled;
+} CullStats;
+
+extern CullStats cull_stats;
+
+void frustum_from_matrix(Frustum *f, const float *view_proj);
+
+bool frustum_test_sphere(const Frustum *f, float x, float y, float z, float r);
+bool frustum_test_aabb(const Frustum *f, const float lo[3], const float hi[3]);
+
+/* Tests count spheres of radius r centred at (x[i], y[i], z[i]), four per SIMD step, and writes
+ * visible[i] = 1 or 0. Returns how many are visible. */
+int frustum_test_spheres(const Frustum *f, const float *x, const float *y, const float *z,
+                         float r, int count, uint8_t *visible);
+
+#endif //U3D_CORE_CULL_H
@@ -0,0 +1,264 @@
+#include "ecs.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define INDEX_BITS ENTITY_INDEX_BITS
+#define INDEX_MASK ((1u << INDEX_BITS) - 1)
+#define MAX_SLOTS  INDEX_MASK   // the all-ones index is reserved for ENTITY_NONE
+
+static const uint32_t field_component[FIELD_COUNT] = {
+        COMP_POSITION, COMP_POSITION, COMP_POSITION,
+        COMP_SPIN, COMP_SPIN,
+        COMP_SHAPE, COMP_SHAPE, COMP_SHAPE,
+        COMP_COLOR, COMP_COLOR, COMP_COLOR,
+        COMP_ANIM,
+        COMP_HISTORY, COMP_HISTORY, COMP_HISTORY,
+        COMP_HISTORY
+};
+
+/* ================= STORAGE ================= */
+
+typedef struct {
+    uint32_t   components;
+    EcsChunk **chunks;       // all full except the last
+    int        chunk_count;
+    int        chunk_capacity;
+} Archetype;
+
+/* Where a slot's entity lives; generation survives destroy so old handles stop resolving. */
+typedef struct {
+    int     archetype;       // -1 = free slot
+    int     chunk;
+    int     row;
+    uint8_t generation;
+} Slot;
+
+static Archetype archetypes[ECS_MAX_ARCHETYPES];
+static int archetype_count;
+
+static Slot     *slots;
+static uint32_t  slot_count, slot_capacity;
+static uint32_t *free_slots;
+static uint32_t  free_count;
+
+static uint32_t handle_index(Entity e)      { return entity_index(e); }
+static uint8_t  handle_generation(Entity e) { return (uint8_t) (e >> INDEX_BITS); }
+static Entity   make_handle(uint32_t index, uint8_t gen) {
+    return ((uint32_t) gen << INDEX_BITS) | index;
+}
+
+static int find_archetype(uint32_t components) {
+    for (int i = 0; i < archetype_count; i++)
+        if (archetypes[i].components == components)
+            return i;
+
+    if (archetype_count == ECS_MAX_ARCHETYPES)
+        return -1;
+
+    Archetype *a = &archetypes[archetype_count];
+    memset(a, 0, sizeof(*a));
+    a->components = components;
+    return archetype_count++;
+}
+
+/* Header and every column in one allocation; columns start 16-byte aligned for f4 loads. */
+static EcsChunk *chunk_alloc(uint32_t components) {
+    size_t header = (sizeof(EcsChunk) + 15) & ~(size_t) 15;
+    int columns = 0;
+    for (int f = 0; f < FIELD_COUNT; f++)
+        if (components & field_component[f])
+            columns++;
+
+    size_t size = header + (size_t) columns * ECS_CHUNK_ROWS * sizeof(float);
+    void *block = NULL;
+    if (posix_memalign(&block, 16, size) != 0)
+        return NULL;
+    memset(block, 0, size);
+
+    char *mem = (char *) block;
+    EcsChunk *c = (EcsChunk *) mem;
+    float *col = (float *) (mem + header);
+    for (int f = 0; f < FIELD_COUNT; f++) {
+        if (components & field_component[f]) {
+            c->field[f] = col;
+            col += ECS_CHUNK_ROWS;
+        }
+    }
+    return c;
+}
+
+/* ================= ENTITIES ================= */
+
+Entity ecs_create(uint32_t components) {
+    int ai = find_archetype(components);
+    if (ai < 0)
+        return ENTITY_NONE;
+    Archetype *a = &archetypes[ai];
+
+    uint32_t index;
+    if (free_count > 0) {
+        index = free_slots[--free_count];
+    } else {
+        if (slot_count == MAX_SLOTS)
+            return ENTITY_NONE;
+        if (slot_count == slot_capacity) {
+            slot_capacity = slot_capacity ? slot_capacity * 2 : 256;
+            slots = (Slot *) realloc(slots, sizeof(Slot) * slot_capacity);
+            free_slots = (uint32_t *) realloc(free_slots, sizeof(uint32_t) * slot_capacity);
+        }
+        index = slot_count++;
+        slots[index].generation = 0;
+    }
+
+    if (a->chunk_count == 0 || a->chunks[a->chunk_count - 1]->count == ECS_CHUNK_ROWS) {
+        if (a->chunk_count == a->chunk_capacity) {
+            a->chunk_capacity = a->chunk_capacity ? a->chunk_capacity * 2 : 4;
+            a->chunks = (EcsChunk **) realloc(a->chunks, sizeof(EcsChunk *) * a->chunk_capacity);
+        }
+        EcsChunk *fresh = chunk_alloc(components);
+        if (!fresh)
+            return ENTITY_NONE;
+        a->chunks[a->chunk_count++] = fresh;
+    }
+
+    int ci = a->chunk_count - 1;
+    EcsChunk *c = a->chunks[ci];
+    int row = c->count++;
+
+    for (int f = 0; f < FIELD_COUNT; f++)
+        if (c->field[f])
+            c->field[f][row] = 0.0f;
+
+    Slot *s = &slots[index];
+    s->archetype = ai;
+    s->chunk = ci;
+    s->row = row;
+
+    Entity e = make_handle(index, s->generation);
+    c->entity[row] = e;
+    return e;
+}
+
+void ecs_destroy(Entity e) {
+    int row;
+    EcsChunk *c = ecs_chunk_of(e, &row);
+    if (!c)
+        return;
+
+    Slot *s = &slots[handle_index(e)];
+    Archetype *a = &archetypes[s->archetype];
+    EcsChunk *last = a->chunks[a->chunk_count - 1];
+    int last_row = last->count - 1;
+
+    /* Fill the hole with the archetype's last row. */
+    if (c != last || row != last_row) {
+        Entity moved = last->entity[last_row];
+        for (int f = 0; f < FIELD_COUNT; f++)
+            if (c->field[f])
+                c->field[f][row] = last->field[f][last_row];
+        c->entity[row] = moved;
+
+        Slot *ms = &slots[handle_index(moved)];
+        ms->chunk = s->chunk;
+        ms->row = row;
+    }
+
+    if (--last->count == 0) {
+        free(a->chunks[--a->chunk_count]);
+    } else {
+        /* rows past count stay zero, so SIMD systems can run over them harmlessly */
+        for (int f = 0; f < FIELD_COUNT; f++)
+            if (last->field[f])
+                last->field[f][last_row] = 0.0f;
+    }
+
+    s->archetype = -1;
+    s->generation++;
+    free_slots[free_count++] = handle_index(e);
+}
+
+bool ecs_alive(Entity e) {
+    uint32_t index = handle_index(e);
+    return index < slot_count &&
+           slots[index].archetype >= 0 &&
+           slots[index].generation == handle_generation(e);
+}
+
+EcsChunk *ecs_chunk_of(Entity e, int *row) {
+    if (!ecs_alive(e))
+        return NULL;
+    const Slot *s = &slots[handle_index(e)];
+    *row = s->row;
+    return archetypes[s->archetype].chunks[s->chunk];
+}
+
+float *ecs_get(Entity e, int field) {
+    int row;
+    EcsChunk *c = ecs_chunk_of(e, &row);
+    if (!c || !c->field[field])
+        return NULL;
+    return &c->field[field][row];
+}
+
+int ecs_count(uint32_t components) {
+    int n = 0;
+    for (int i = 0; i < archetype_count; i++) {
+        const Archetype *a = &archetypes[i];
+        if ((a->components & components) != components || a->chunk_count == 0)
+            continue;
+        n += (a->chunk_count - 1) * ECS_CHUNK_ROWS + a->chunks[a->chunk_count - 1]->count;
+    }
+    return n;
+}
+
+void ecs_clear() {
+    for (int i = 0; i < archetype_count; i++) {
+        for (int c = 0; c < archetypes[i].chunk_count; c++)
+            free(archetypes[i].chunks[c]);
+        archetypes[i].chunk_count = 0;
+    }
+
+    /* Bump generations so handles held elsewhere go stale. */
+    free_count = 0;
+    for (uint32_t i = slot_count; i-- > 0;) {
+        if (slots[i].archetype >= 0) {
+            slots[i].archetype = -1;
+            slots[i].generation++;
+        }
+        free_slots[free_count++] = i;
+    }
+}
+
+/* ================= QUERIES ================= */
+
+EcsQuery ecs_query(uint32_t components) {
+    EcsQuery q;
+    q.components = components;
+    q.archetype = 0;
+    q.chunk = 0;
+    return q;
+}
+
+EcsChunk *ecs_next(EcsQuery *q) {
+    for (; q->archetype < archetype_count; q->archetype++, q->chunk = 0) {
+        const Archetype *a = &archetypes[q->archetype];
+        if ((a->components & q->components) != q->components)
+            continue;
+        if (q->chunk < a->chunk_count)
+            return a->chunks[q->chunk++];
+    }
+    return NULL;
+}
+
+void ecs_gather(EcsChunkList *list, uint32_t components) {
+    list->count = 0;
+    EcsQuery q = ecs_query(components);
+    while (EcsChunk *c = ecs_next(&q)) {
+        if (list->count == list->capacity) {
+            list->capacity = list->capacity ? list->capacity * 2 : 16;
+            list->chunk = (EcsChunk **) realloc(list->chunk, sizeof(EcsChunk *) * list->capacity);
+        }
+        list->chunk[list->count++] = c;
+    }
+}
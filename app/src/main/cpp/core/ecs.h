@@ -0,0 +1,99 @@
+#ifndef U3D_CORE_ECS_H
+#define U3D_CORE_ECS_H
+
+#include <stdint.h>
+
+/* ================= ENTITIES =================
+ * Archetype store. Entities with the same component set share an archetype, whose data lives in
+ * fixed-size chunks laid out as one float column per field (structure of arrays), so a system
+ * only streams the columns it reads and cold data (shape, colour) stays out of the hot loops.
+ *
+ * An Entity is a handle: slot index in the low 24 bits, generation in the high 8, so a handle
+ * to a destroyed entity stops resolving. Destroying moves the archetype's last row into the
+ * hole to keep chunks dense; chunk pointers and rows are only valid until the next
+ * create/destroy.
+ */
+
+typedef uint32_t Entity;
+
+#define ENTITY_NONE 0xFFFFFFFFu
+#define ENTITY_INDEX_BITS 24
+
+/* Slot index of a handle: dense and stable for the entity's lifetime, so side tables (e.g. the
+ * spatial index) can be addressed by it. */
+static inline uint32_t entity_index(Entity e) { return e & ((1u << ENTITY_INDEX_BITS) - 1); }
+
+/* One float column per field, grouped by the component that owns it. */
+enum EcsField {
+    FIELD_X, FIELD_Y, FIELD_Z,                 // COMP_POSITION
+    FIELD_ROT, FIELD_ROT_VEL,                  // COMP_SPIN
+    FIELD_HEIGHT, FIELD_WIDTH, FIELD_DEPTH,    // COMP_SHAPE
+    FIELD_R, FIELD_G, FIELD_B,                 // COMP_COLOR
+    FIELD_ANIM_PHASE,                          // COMP_ANIM
+    FIELD_PREV_X, FIELD_PREV_Y, FIELD_PREV_Z,  // COMP_HISTORY: pose at the previous sim step
+    FIELD_PREV_ROT,
+    FIELD_COUNT
+};
+
+enum EcsComponent {
+    COMP_POSITION = 1 << 0,
+    COMP_SPIN     = 1 << 1,
+    COMP_SHAPE    = 1 << 2,
+    COMP_COLOR    = 1 << 3,
+    COMP_ANIM     = 1 << 4,
+    COMP_HISTORY  = 1 << 5
+};
+
+#define ECS_CHUNK_ROWS     1024   // multiple of 4: SIMD systems may run past count to the next 4
+                                  // (rows past count are kept zeroed)
+#define ECS_MAX_ARCHETYPES 32
+
+typedef struct {
+    int    count;
+    Entity entity[ECS_CHUNK_ROWS];
+    float *field[FIELD_COUNT];     // ECS_CHUNK_ROWS floats each, NULL if the archetype lacks it
+} EcsChunk;
+
+/* Chunk iterator over every archetype that has all of `components`. */
+typedef struct {
+    uint32_t components;
+    int archetype;
+    int chunk;
+} EcsQuery;
+
+/* Creates an entity with the given component mask; all its fields start at 0. */
+Entity ecs_create(uint32_t components);
+
+/* Destroys e. Stale or ENTITY_NONE handles are ignored. */
+void ecs_destroy(Entity e);
+
+bool ecs_alive(Entity e);
+
+/* Chunk holding e and its row, or NULL if e is not alive. */
+EcsChunk *ecs_chunk_of(Entity e, int *row);
+
+/* Pointer to one field of e, or NULL if e is dead or lacks the component. */
+float *ecs_get(Entity e, int field);
+
+/* Number of live entities that have all of `components`. */
+int ecs_count(uint32_t components);
+
+/* Destroys every entity and releases all chunks. */
+void ecs_clear();
+
+EcsQuery ecs_query(uint32_t components);
+
+/* Next non-empty matching chunk, or NULL when the query is exhausted. */
+EcsChunk *ecs_next(EcsQuery *q);
+
+/* Every matching chunk in query order, so a system can hand chunks to parallel_for. The list
+ * keeps its storage between calls. */
+typedef struct {
+    EcsChunk **chunk;
+    int        count;
+    int        capacity;
+} EcsChunkList;
+
+void ecs_gather(EcsChunkList *list, uint32_t components);
+
+#endif //U3D_CORE_ECS_H
@@ -0,0 +1,21 @@
+#include "engine.h"
+
+Engine engine;
+
+void engine_init(int width, int height) {
+    engine.width = width;
+    engine.height = height;
+    engine.cursor_ndc_x = 0.0f;
+    engine.cursor_ndc_y = 0.0f;
+    engine.active_axis = -1;
+    engine.grabbed = ENTITY_NONE;
+    engine.selected = ENTITY_NONE;
+    engine.player = ENTITY_NONE;
+
+/* ===== INITIAL CAMERA POSE (GOOD DEFAULT) ===== */
+    engine.cam_yaw   = 0.0f;     // facing +Z
+    engine.cam_pitch = -0.25f;   // slight downward tilt
+    engine.cam_x     = 0.0f;
+    engine.cam_y     = -0.3f;
+    engine.cam_z     = -6.0f;
+}
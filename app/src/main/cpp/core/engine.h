@@ -0,0 +1,49 @@
+#ifndef U3D_CORE_ENGINE_H
+#define U3D_CORE_ENGINE_H
+
+/* ================= ENGINE STATE =================
+ * Camera, UI and input state shared by input handling, simulation and drawing. Platform handles
+ * (EGL display/surface/context) live with the platform glue, not here.
+ */
+
+#include "ecs.h"
+
+struct Engine{
+    int width,height;
+    Entity grabbed,selected;   // ENTITY_NONE = none
+    Entity player;             // moved by the left joystick
+    float last_x,last_y;
+    float grab_offset[3];      // grabbed root minus the picked surface point
+    float cursor_ndc_x;
+    float cursor_ndc_y;
+    float joyL_x, joyL_y;
+    float joyR_x, joyR_y;
+    bool  joyL_active;
+    bool  joyR_active;
+    float cam_yaw;
+    float cam_pitch;
+    float cam_x;
+    float cam_y;
+    float cam_z;
+    /* ===== AXIS LOCKS ===== */
+    bool lock_cam_x;
+    bool lock_cam_y;
+    bool lock_cam_z;
+
+    bool lock_obj_x;
+    bool lock_obj_y;
+    bool lock_obj_z;
+    float pinch_start_dist;
+    float pinch_start_cam_z;
+    float pinch_last_cx;
+    float pinch_last_cy;
+    /* ===== ACTIVE AXIS (UI) ===== */
+    int active_axis;   // -1 = none, 0 = X, 1 = Y, 2 = Z
+};
+
+extern Engine engine;
+
+/* Sets the surface size and the default cursor / camera pose. */
+void engine_init(int width, int height);
+
+#endif //U3D_CORE_ENGINE_H
@@ -0,0 +1,218 @@
+#include "etc2.h"
+
+#include <string.h>
+
+/* Block layouts and tables follow the OpenGL ES 3.0 specification, section C.1. Blocks are
+ * read as big-endian 64-bit words, so bit numbers below match the specification's. */
+
+static const int MODIFIERS[8][2] = {{2, 8},   {5, 17},  {9, 29},  {13, 42},
+                                    {18, 60}, {24, 80}, {33, 106}, {47, 183}};
+
+static const int DISTANCES[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+static const int EAC_MODIFIERS[16][8] = {
+        {-3, -6, -9, -15, 2, 5, 8, 14},  {-3, -7, -10, -13, 2, 6, 9, 12},
+        {-2, -5, -8, -13, 1, 4, 7, 12},  {-2, -4, -6, -13, 1, 3, 5, 12},
+        {-3, -6, -8, -12, 2, 5, 7, 11},  {-3, -7, -9, -11, 2, 6, 8, 10},
+        {-4, -7, -8, -11, 3, 6, 7, 10},  {-3, -5, -8, -11, 2, 4, 7, 10},
+        {-2, -6, -8, -10, 1, 5, 7, 9},   {-2, -5, -8, -10, 1, 4, 7, 9},
+        {-2, -4, -8, -10, 1, 3, 7, 9},   {-2, -5, -7, -10, 1, 4, 6, 9},
+        {-3, -4, -7, -10, 2, 3, 6, 9},   {-1, -2, -3, -10, 0, 1, 2, 9},
+        {-4, -6, -8, -9, 3, 5, 7, 8},    {-3, -5, -7, -9, 2, 4, 6, 8}};
+
+static uint64_t big_endian(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++)
+        v = v << 8 | p[i];
+    return v;
+}
+
+static int bits(uint64_t block, int low, int count) {
+    return (int) (block >> low) & ((1 << count) - 1);
+}
+
+static uint8_t clamp(int v) {
+    return (uint8_t) (v < 0 ? 0 : v > 255 ? 255 : v);
+}
+
+static int extend4(int v) { return v << 4 | v; }
+static int extend5(int v) { return v << 3 | v >> 2; }
+static int extend6(int v) { return v << 2 | v >> 4; }
+static int extend7(int v) { return v << 1 | v >> 6; }
+
+/* 2-bit index of pixel (x, y): most significant bit in 16..31, least in 0..15, column-major. */
+static int pixel_index(uint64_t block, int x, int y) {
+    int i = x * 4 + y;
+    return bits(block, 16 + i, 1) << 1 | bits(block, i, 1);
+}
+
+static void set(uint8_t *texel, int r, int g, int b, int a) {
+    texel[0] = clamp(r);
+    texel[1] = clamp(g);
+    texel[2] = clamp(b);
+    texel[3] = (uint8_t) a;
+}
+
+/* T and H modes: four paint colours picked directly by the pixel index. */
+static void decode_paint(uint64_t block, const int paint[4][3], bool punchthrough,
+                         uint8_t out[16][4]) {
+    for (int x = 0; x < 4; x++) {
+        for (int y = 0; y < 4; y++) {
+            int index = pixel_index(block, x, y);
+            if (punchthrough && index == 2)
+                set(out[y * 4 + x], 0, 0, 0, 0);
+            else
+                set(out[y * 4 + x], paint[index][0], paint[index][1], paint[index][2], 255);
+        }
+    }
+}
+
+static void decode_t(uint64_t block, bool punchthrough, uint8_t out[16][4]) {
+    int c0[3] = {extend4(bits(block, 59, 2) << 2 | bits(block, 56, 2)),
+                 extend4(bits(block, 52, 4)), extend4(bits(block, 48, 4))};
+    int c1[3] = {extend4(bits(block, 44, 4)), extend4(bits(block, 40, 4)),
+                 extend4(bits(block, 36, 4))};
+    int d = DISTANCES[bits(block, 34, 2) << 1 | bits(block, 32, 1)];
+    int paint[4][3];
+    for (int k = 0; k < 3; k++) {
+        paint[0][k] = c0[k];
+        paint[1][k] = c1[k] + d;
+        paint[2][k] = c1[k];
+        paint[3][k] = c1[k] - d;
+    }
+    decode_paint(block, paint, punchthrough, out);
+}
+
+static void decode_h(uint64_t block, bool punchthrough, uint8_t out[16][4]) {
+    int r0 = bits(block, 59, 4);
+    int g0 = bits(block, 56, 3) << 1 | bits(block, 52, 1);
+    int b0 = bits(block, 51, 1) << 3 | bits(block, 47, 3);
+    int r1 = bits(block, 43, 4), g1 = bits(block, 39, 4), b1 = bits(block, 35, 4);
+    /* the order of the two colours carries the distance's lowest bit */
+    int order = (r0 << 8 | g0 << 4 | b0) >= (r1 << 8 | g1 << 4 | b1);
+    int d = DISTANCES[bits(block, 34, 1) << 2 | bits(block, 32, 1) << 1 | order];
+    int c0[3] = {extend4(r0), extend4(g0), extend4(b0)};
+    int c1[3] = {extend4(r1), extend4(g1), extend4(b1)};
+    int paint[4][3];
+    for (int k = 0; k < 3; k++) {
+        paint[0][k] = c0[k] + d;
+        paint[1][k] = c0[k] - d;
+        paint[2][k] = c1[k] + d;
+        paint[3][k] = c1[k] - d;
+    }
+    decode_paint(block, paint, punchthrough, out);
+}
+
+static void decode_planar(uint64_t block, uint8_t out[16][4]) {
+    int o[3] = {extend6(bits(block, 57, 6)),
+                extend7(bits(block, 56, 1) << 6 | bits(block, 49, 6)),
+                extend6(bits(block, 48, 1) << 5 | bits(block, 43, 2) << 3 | bits(block, 39, 3))};
+    int h[3] = {extend6(bits(block, 34, 5) << 1 | bits(block, 32, 1)),
+                extend7(bits(block, 25, 7)), extend6(bits(block, 19, 6))};
+    int v[3] = {extend6(bits(block, 13, 6)), extend7(bits(block, 6, 7)),
+                extend6(bits(block, 0, 6))};
+    for (int x = 0; x < 4; x++) {
+        for (int y = 0; y < 4; y++) {
+            int c[3];
+            for (int k = 0; k < 3; k++)
+                c[k] = (x * (h[k] - o[k]) + y * (v[k] - o[k]) + 4 * o[k] + 2) >> 2;
+            set(out[y * 4 + x], c[0], c[1], c[2], 255);
+        }
+    }
+}
+
+/* One RGB8 or RGB8A1 block into 16 RGBA texels, row-major. */
+static void decode_color(uint64_t block, bool punchthrough, uint8_t out[16][4]) {
+    bool diff = bits(block, 33, 1);
+    bool opaque = !punchthrough || diff;
+    int base[2][3];
+    if (diff || punchthrough) {
+        /* differential; a second colour out of range selects one of the other modes */
+        static const int low[3] = {59, 51, 43};
+        for (int k = 0; k < 3; k++) {
+            int c = bits(block, low[k], 5);
+            int delta = bits(block, low[k] - 3, 3);
+            int c1 = c + (delta >= 4 ? delta - 8 : delta);
+            if (c1 < 0 || c1 > 31) {
+                if (k == 0)
+                    decode_t(block, !opaque, out);
+                else if (k == 1)
+                    decode_h(block, !opaque, out);
+                else
+                    decode_planar(block, out);
+                return;
+            }
+            base[0][k] = extend5(c);
+            base[1][k] = extend5(c1);
+        }
+    } else {
+        for (int k = 0; k < 3; k++) {
+            base[0][k] = extend4(bits(block, 60 - 8 * k, 4));
+            base[1][k] = extend4(bits(block, 56 - 8 * k, 4));
+        }
+    }
+
+    int table[2] = {bits(block, 37, 3), bits(block, 34, 3)};
+    bool flip = bits(block, 32, 1);
+    for (int x = 0; x < 4; x++) {
+        for (int y = 0; y < 4; y++) {
+            int sub = flip ? y >= 2 : x >= 2;
+            const int *m = MODIFIERS[table[sub]];
+            int index = pixel_index(block, x, y);
+            uint8_t *texel = out[y * 4 + x];
+            if (!opaque && index == 2) {
+                set(texel, 0, 0, 0, 0);
+                continue;
+            }
+            /* index 0, 1, 2, 3: +a, +b, -a, -b; without the opaque bit a is 0 */
+            int modifier = index & 1 ? m[1] : opaque ? m[0] : 0;
+            if (index & 2)
+                modifier = -modifier;
+            const int *c = base[sub];
+            set(texel, c[0] + modifier, c[1] + modifier, c[2] + modifier, 255);
+        }
+    }
+}
+
+static void decode_alpha(uint64_t block, uint8_t out[16][4]) {
+    int base = bits(block, 56, 8), multiplier = bits(block, 52, 4);
+    const int *modifiers = EAC_MODIFIERS[bits(block, 48, 4)];
+    for (int x = 0; x < 4; x++)
+        for (int y = 0; y < 4; y++)
+            out[y * 4 + x][3] = clamp(base + modifiers[bits(block, 45 - 3 * (x * 4 + y), 3)] *
+                                             multiplier);
+}
+
+bool etc2_format(GLenum internal_format) {
+    return internal_format >= GL_COMPRESSED_RGB8_ETC2 &&
+           internal_format <= GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC;
+}
+
+void etc2_decode_level(const TextureImage *image, int level, uint8_t *rgba) {
+    GLenum format = image->internal_format;
+    bool punchthrough = format == GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 ||
+                        format == GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2;
+    bool eac = format == GL_COMPRESSED_RGBA8_ETC2_EAC ||
+               format == GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC;
+    int width = image->width >> level > 0 ? image->width >> level : 1;
+    int height = image->height >> level > 0 ? image->height >> level : 1;
+
+    const uint8_t *src = image->level[level];
+    for (int by = 0; by < height; by += 4) {
+        for (int bx = 0; bx < width; bx += 4) {
+            uint8_t texels[16][4];
+            if (eac) {
+                decode_color(big_endian(src + 8), false, texels);
+                decode_alpha(big_endian(src), texels);
+            } else {
+                decode_color(big_endian(src), punchthrough, texels);
+            }
+            src += image->block_bytes;
+
+            /* the last column and row of blocks may hang over the edge */
+            for (int y = 0; y < 4 && by + y < height; y++)
+                for (int x = 0; x < 4 && bx + x < width; x++)
+                    memcpy(rgba + ((size_t) (by + y) * width + bx + x) * 4, texels[y * 4 + x], 4);
+        }
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef U3D_CORE_ETC2_H
+#define U3D_CORE_ETC2_H
+
+#include "texture.h"
+
+#include <stdint.h>
+
+/* ================= ETC2 =================
+ * CPU decoder for the ETC2/EAC formats ES3 samples natively: RGB8, RGB8 with punchthrough alpha
+ * and RGBA8 with EAC alpha (sRGB variants decode to the same bytes). Only for contexts without
+ * ETC2 (ES2, and the host stub under --es2): it restores 4 bytes per texel, which is exactly
+ * what compressed textures are meant to avoid, so a device path should never need it.
+ */
+
+/* Whether etc2_decode_level handles internal_format. */
+bool etc2_format(GLenum internal_format);
+
+/* Decodes one level of image into tightly packed RGBA8 rows of its width x height. */
+void etc2_decode_level(const TextureImage *image, int level, uint8_t *rgba);
+
+#endif //U3D_CORE_ETC2_H
@@ -0,0 +1,115 @@
+#include "geometry.h"
+
+#include <math.h>
+
+/* ================= CUBE ================= */
+
+const float cube_vertices[36 * 9] = {
+        -0.5, -0.5, 0.5, 1, 0, 0, 0, 0, 1, 0.5, -0.5, 0.5, 1, 0, 0, 0, 0, 1, 0.5, 0.5, 0.5,
+        1, 0, 0, 0, 0, 1,
+        -0.5, -0.5, 0.5, 1, 0, 0, 0, 0, 1, 0.5, 0.5, 0.5, 1, 0, 0, 0, 0, 1, -0.5, 0.5, 0.5,
+        1, 0, 0, 0, 0, 1,
+        -0.5, -0.5, -0.5, 0, 1, 0, 0, 0, -1, -0.5, 0.5, -0.5, 0, 1, 0, 0, 0, -1, 0.5, 0.5,
+        -0.5, 0, 1, 0, 0, 0, -1,
+        -0.5, -0.5, -0.5, 0, 1, 0, 0, 0, -1, 0.5, 0.5, -0.5, 0, 1, 0, 0, 0, -1, 0.5, -0.5,
+        -0.5, 0, 1, 0, 0, 0, -1,
+        -0.5, -0.5, -0.5, 0, 0, 1, -1, 0, 0, -0.5, -0.5, 0.5, 0, 0, 1, -1, 0, 0, -0.5, 0.5,
+        0.5, 0, 0, 1, -1, 0, 0,
+        -0.5, -0.5, -0.5, 0, 0, 1, -1, 0, 0, -0.5, 0.5, 0.5, 0, 0, 1, -1, 0, 0, -0.5, 0.5,
+        -0.5, 0, 0, 1, -1, 0, 0,
+        0.5, -0.5, -0.5, 1, 1, 0, 1, 0, 0, 0.5, 0.5, -0.5, 1, 1, 0, 1, 0, 0, 0.5, 0.5, 0.5,
+        1, 1, 0, 1, 0, 0,
+        0.5, -0.5, -0.5, 1, 1, 0, 1, 0, 0, 0.5, 0.5, 0.5, 1, 1, 0, 1, 0, 0, 0.5, -0.5, 0.5,
+        1, 1, 0, 1, 0, 0,
+        -0.5, 0.5, -0.5, 0, 1, 1, 0, 1, 0, -0.5, 0.5, 0.5, 0, 1, 1, 0, 1, 0, 0.5, 0.5, 0.5,
+        0, 1, 1, 0, 1, 0,
+        -0.5, 0.5, -0.5, 0, 1, 1, 0, 1, 0, 0.5, 0.5, 0.5, 0, 1, 1, 0, 1, 0, 0.5, 0.5, -0.5,
+        0, 1, 1, 0, 1, 0,
+        -0.5, -0.5, -0.5, 1, 0, 1, 0, -1, 0, 0.5, -0.5, -0.5, 1, 0, 1, 0, -1, 0, 0.5, -0.5,
+        0.5, 1, 0, 1, 0, -1, 0,
+        -0.5, -0.5, -0.5, 1, 0, 1, 0, -1, 0, 0.5, -0.5, 0.5, 1, 0, 1, 0, -1, 0, -0.5, -0.5,
+        0.5, 1, 0, 1, 0, -1, 0
+};
+
+/* ================= SKYBOX ================= */
+
+/* Clip-space triangle covering the whole viewport; the parts outside are clipped. */
+const float sky_triangle_vertices[3 * 2] = {
+        -1, -1,  3, -1,  -1, 3
+};
+
+/* ================= GROUND PLANE ================= */
+
+const float ground_quad_vertices[6 * 3] = {
+        -1, 0, -1,  -1, 0, 1,  1, 0, 1,
+        -1, 0, -1,   1, 0, 1,  1, 0, -1
+};
+
+/* ================= AXES ================= */
+
+const float axis_vertices[6 * 6] = {
+        -5, 0, 0, 1, 0, 0, 5, 0, 0, 1, 0, 0,
+        0, -5, 0, 0, 1, 0, 0, 5, 0, 0, 1, 0,
+        0, 0, -5, 0, 0, 1, 0, 0, 5, 0, 0, 1
+};
+
+/* ================= CURSOR ================= */
+
+const float cursor_vertices[4 * 5] = {
+        -0.05f, 0.0f, 1, 1, 1, 0.05f, 0.0f, 1, 1, 1,
+        0.0f, -0.05f, 1, 1, 1, 0.0f, 0.05f, 1, 1, 1
+};
+
+/* ================= AXIS LABEL GLYPHS ================= */
+
+const float glyph_X[4 * 5] = {
+        -0.03f, -0.03f, 1,1,1,
+        0.03f,  0.03f, 1,1,1,
+
+        -0.03f,  0.03f, 1,1,1,
+        0.03f, -0.03f, 1,1,1,
+};
+
+const float glyph_Y[6 * 5] = {
+        -0.03f,  0.03f, 1,1,1,
+        0.00f,  0.00f, 1,1,1,
+
+        0.03f,  0.03f, 1,1,1,
+        0.00f,  0.00f, 1,1,1,
+
+        0.00f,  0.00f, 1,1,1,
+        0.00f, -0.04f, 1,1,1,
+};
+
+const float glyph_Z[6 * 5] = {
+        -0.03f,  0.03f, 1,1,1,
+        0.03f,  0.03f, 1,1,1,
+
+        0.03f,  0.03f, 1,1,1,
+        -0.03f, -0.03f, 1,1,1,
+
+        -0.03f, -0.03f, 1,1,1,
+        0.03f, -0.03f, 1,1,1,
+};
+
+/* ================= SELECTION RING ================= */
+
+void build_sel_ring(float *sel_ring) {
+    int si = 0;
+
+    for (int i = 0; i < SEL_SEGMENTS; i++) {
+        float a0 = (float)i / SEL_SEGMENTS * 2.0f * M_PI;
+        float a1 = (float)(i + 1) / SEL_SEGMENTS * 2.0f * M_PI;
+
+        // XZ ring
+        sel_ring[si++] = cosf(a0) * PICK_RADIUS;
+        sel_ring[si++] = 0.0f;
+        sel_ring[si++] = sinf(a0) * PICK_RADIUS;
+        sel_ring[si++] = 1.0f; sel_ring[si++] = 1.0f; sel_ring[si++] = 0.2f;
+
+        sel_ring[si++] = cosf(a1) * PICK_RADIUS;
+        sel_ring[si++] = 0.0f;
+        sel_ring[si++] = sinf(a1) * PICK_RADIUS;
+        sel_ring[si++] = 1.0f; sel_ring[si++] = 1.0f; sel_ring[si++] = 0.2f;
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef U3D_CORE_GEOMETRY_H
+#define U3D_CORE_GEOMETRY_H
+
+#include "config.h"
+
+/* ================= STATIC GEOMETRY =================
+ * CPU-side vertex data for every mesh the scene uploads. World meshes are interleaved
+ * position/color(/normal) in floats, screen-space meshes are position(2)/color(3).
+ */
+
+/* cube: pos(3) color(3) normal(3), 36 vertices */
+extern const float cube_vertices[36 * 9];
+
+/* skybox: clip-space pos(2), one full-screen triangle */
+extern const float sky_triangle_vertices[3 * 2];
+
+/* ground plane: pos(3), unit quad in XZ (+-1) as 2 triangles */
+extern const float ground_quad_vertices[6 * 3];
+
+/* world axes: pos(3) color(3), 3 lines */
+extern const float axis_vertices[6 * 6];
+
+/* cursor cross: pos(2) color(3), 2 lines */
+extern const float cursor_vertices[4 * 5];
+
+/* Screen-space line glyphs, centered at origin */
+extern const float glyph_X[4 * 5];
+extern const float glyph_Y[6 * 5];
+extern const float glyph_Z[6 * 5];
+
+/* Ground (XZ) selection ring as GL_LINES, pos(3) color(3). Writes SEL_SEGMENTS * 12 floats. */
+void build_sel_ring(float *out);
+
+
+#endif //U3D_CORE_GEOMETRY_H
@@ -0,0 +1,88 @@
+#include "gl_caps.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifndef GL_HALF_FLOAT_OES
+#define GL_HALF_FLOAT_OES 0x8D61
+#endif
+
+GlCaps gl_caps;
+
+bool gl_has_extension(const char *name) {
+    const char *list = (const char *) glGetString(GL_EXTENSIONS);
+    if (!list)
+        return false;
+
+    size_t len = strlen(name);
+    for (const char *p = list; (p = strstr(p, name)); p += len) {
+        bool starts = p == list || p[-1] == ' ';
+        bool ends = p[len] == ' ' || p[len] == '\0';
+        if (starts && ends)
+            return true;
+    }
+    return false;
+}
+
+void gl_caps_init() {
+    gl_caps.es_major = 2;
+    gl_caps.es_minor = 0;
+
+    /* "OpenGL ES <major>.<minor> <vendor-specific>" */
+    const char *version = (const char *) glGetString(GL_VERSION);
+    if (version)
+        sscanf(version, "OpenGL ES %d.%d", &gl_caps.es_major, &gl_caps.es_minor);
+
+    gl_caps.instancing = gl_caps.es_major >= 3;
+    gl_caps.packed_normals = gl_caps.es_major >= 3;
+    gl_caps.pixel_buffers = gl_caps.es_major >= 3;
+    gl_caps.etc2 = gl_caps.es_major >= 3;
+    /* ASTC is core only from ES 3.2, and even then some drivers only list the extension */
+    gl_caps.astc = gl_caps.es_major >= 3 &&
+                   gl_has_extension("GL_KHR_texture_compression_astc_ldr");
+
+    if (gl_caps.es_major >= 3) {
+        gl_caps.half_float_vertex = true;
+        gl_caps.half_float_type = GL_HALF_FLOAT;
+    } else {
+        gl_caps.half_float_vertex = gl_has_extension("GL_OES_vertex_half_float");
+        gl_caps.half_float_type = GL_HALF_FLOAT_OES;
+    }
+
+    gl_caps.gen_vertex_arrays = NULL;
+    gl_caps.bind_vertex_array = NULL;
+    if (gl_caps.es_major >= 3) {
+        gl_caps.gen_vertex_arrays = glGenVertexArrays;
+        gl_caps.bind_vertex_array = glBindVertexArray;
+    } else if (gl_has_extension("GL_OES_vertex_array_object")) {
+        gl_caps.gen_vertex_arrays = (void (GL_APIENTRY *)(GLsizei, GLuint *))
+                gles_proc_address("glGenVertexArraysOES");
+        gl_caps.bind_vertex_array = (void (GL_APIENTRY *)(GLuint))
+                gles_proc_address("glBindVertexArrayOES");
+    }
+    gl_caps.vertex_arrays = gl_caps.gen_vertex_arrays && gl_caps.bind_vertex_array;
+
+    gl_caps.get_program_binary = NULL;
+    gl_caps.program_binary_load = NULL;
+    if (gl_caps.es_major >= 3) {
+        gl_caps.get_program_binary = glGetProgramBinary;
+        gl_caps.program_binary_load = glProgramBinary;
+    } else if (gl_has_extension("GL_OES_get_program_binary")) {
+        gl_caps.get_program_binary = (void (GL_APIENTRY *)(GLuint, GLsizei, GLsizei *, GLenum *,
+                                                            void *))
+                gles_proc_address("glGetProgramBinaryOES");
+        gl_caps.program_binary_load = (void (GL_APIENTRY *)(GLuint, GLenum, const void *, GLsizei))
+                gles_proc_address("glProgramBinaryOES");
+    }
+    /* the entry points alone are not enough: drivers may report zero binary formats */
+    GLint formats = 0;
+    if (gl_caps.get_program_binary && gl_caps.program_binary_load)
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    gl_caps.program_binary = formats > 0;
+
+    gl_caps.max_shader_compiler_threads = NULL;
+    if (gl_has_extension("GL_KHR_parallel_shader_compile"))
+        gl_caps.max_shader_compiler_threads = (void (GL_APIENTRY *)(GLuint))
+                gles_proc_address("glMaxShaderCompilerThreadsKHR");
+    gl_caps.parallel_compile = gl_caps.max_shader_compiler_threads != NULL;
+}
@@ -0,0 +1,48 @@
+#ifndef U3D_CORE_GL_CAPS_H
+#define U3D_CORE_GL_CAPS_H
+
+#include "gles.h"
+
+/* ================= GL CAPABILITIES =================
+ * What the current context can do, queried once after it is made current. Render paths branch
+ * on these flags instead of on the EGL config that was asked for.
+ */
+
+typedef struct {
+    int  es_major;       // 2 or 3, from GL_VERSION
+    int  es_minor;
+    bool instancing;     // glDrawArraysInstanced + glVertexAttribDivisor (ES3)
+    bool vertex_arrays;  // VAOs: core on ES3, GL_OES_vertex_array_object on ES2
+    bool half_float_vertex;  // half-float attributes: ES3, or GL_OES_vertex_half_float
+    GLenum half_float_type;  // GL_HALF_FLOAT or GL_HALF_FLOAT_OES
+    bool packed_normals;     // GL_INT_2_10_10_10_REV attributes (ES3)
+
+    bool program_binary;     // glGetProgramBinary/glProgramBinary with at least one format:
+                             // ES3, or GL_OES_get_program_binary
+    bool parallel_compile;   // GL_KHR_parallel_shader_compile: non-blocking completion queries
+    bool pixel_buffers;      // GL_PIXEL_UNPACK_BUFFER + glMapBufferRange (ES3)
+    bool etc2;               // ETC2/EAC compressed textures (ES3)
+    bool astc;               // ASTC LDR compressed textures: GL_KHR_texture_compression_astc_ldr
+
+    /* VAO entry points, whichever flavour the context has. NULL unless vertex_arrays. */
+    void (GL_APIENTRY *gen_vertex_arrays)(GLsizei n, GLuint *arrays);
+    void (GL_APIENTRY *bind_vertex_array)(GLuint array);
+
+    /* Program binary entry points, likewise. NULL unless program_binary. */
+    void (GL_APIENTRY *get_program_binary)(GLuint program, GLsizei size, GLsizei *length,
+                                           GLenum *format, void *binary);
+    void (GL_APIENTRY *program_binary_load)(GLuint program, GLenum format, const void *binary,
+                                            GLsizei length);
+
+    /* glMaxShaderCompilerThreadsKHR. NULL unless parallel_compile. */
+    void (GL_APIENTRY *max_shader_compiler_threads)(GLuint count);
+} GlCaps;
+
+extern GlCaps gl_caps;
+
+void gl_caps_init();
+
+/* Whether the context's GL_EXTENSIONS lists name (whole-word match). */
+bool gl_has_extension(const char *name);
+
+#endif //U3D_CORE_GL_CAPS_H
@@ -0,0 +1,177 @@
+#include "gl_state.h"
+#include "gl_caps.h"
+
+#include <string.h>
+
+GlStateStats gl_state_stats;
+
+#define UNKNOWN 0xFFFFFFFFu
+
+typedef struct {
+    GLuint    buffer;      // array buffer the pointer was taken from
+    GLint     size;
+    GLenum    type;
+    GLboolean normalized;
+    GLsizei   stride;
+    size_t    offset;
+} AttribPointer;
+
+static struct {
+    GLuint        program;
+    GLuint        vertex_array;
+    GLuint        array_buffer;
+    GLuint        element_buffer; // part of the bound VAO
+    AttribPointer pointer[GLS_MAX_ATTRIBS];
+    GLuint        divisor[GLS_MAX_ATTRIBS];
+    unsigned      enabled;        // attribute arrays known to be enabled
+    unsigned      known;          // attribute arrays whose enable state is known
+    int           depth_test;     // -1 unknown
+    GLenum        depth_func;
+    int           depth_mask;     // -1 unknown
+    int           blend;          // -1 unknown
+    GLfloat       line_width;     // < 0 unknown
+} gls;
+
+/* Counts the call and tells the caller whether to issue it. */
+static bool changed(bool differs) {
+    if (differs)
+        gl_state_stats.issued++;
+    else
+        gl_state_stats.elided++;
+    return differs;
+}
+
+/* Forgets everything the bound VAO owns. */
+static void reset_vertex_array_state() {
+    gls.element_buffer = UNKNOWN;
+    for (int i = 0; i < GLS_MAX_ATTRIBS; i++) {
+        memset(&gls.pointer[i], 0, sizeof(gls.pointer[i]));
+        gls.pointer[i].buffer = UNKNOWN;
+        gls.divisor[i] = UNKNOWN;
+    }
+    gls.enabled = 0;
+    gls.known = 0;
+}
+
+void gls_reset() {
+    gls.program = UNKNOWN;
+    gls.vertex_array = UNKNOWN;
+    gls.array_buffer = UNKNOWN;
+    reset_vertex_array_state();
+    gls.depth_test = -1;
+    gls.depth_func = UNKNOWN;
+    gls.depth_mask = -1;
+    gls.blend = -1;
+    gls.line_width = -1.0f;
+}
+
+void gls_use_program(GLuint program) {
+    if (changed(gls.program != program)) {
+        gls.program = program;
+        glUseProgram(program);
+    }
+}
+
+void gls_bind_vertex_array(GLuint array) {
+    if (changed(gls.vertex_array != array)) {
+        gls.vertex_array = array;
+        gl_caps.bind_vertex_array(array);
+        reset_vertex_array_state();
+    }
+}
+
+void gls_bind_buffer(GLenum target, GLuint buffer) {
+    GLuint *bound = target == GL_ARRAY_BUFFER ? &gls.array_buffer
+                  : target == GL_ELEMENT_ARRAY_BUFFER ? &gls.element_buffer : NULL;
+    if (!bound) {
+        gl_state_stats.issued++;
+        glBindBuffer(target, buffer);
+        return;
+    }
+    if (changed(*bound != buffer)) {
+        *bound = buffer;
+        glBindBuffer(target, buffer);
+    }
+}
+
+void gls_attrib_pointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                        GLsizei stride, size_t offset) {
+    AttribPointer *p = &gls.pointer[index];
+    bool same = p->buffer == gls.array_buffer && p->size == size && p->type == type &&
+                p->normalized == normalized && p->stride == stride && p->offset == offset;
+    if (changed(!same)) {
+        p->buffer = gls.array_buffer;
+        p->size = size;
+        p->type = type;
+        p->normalized = normalized;
+        p->stride = stride;
+        p->offset = offset;
+        glVertexAttribPointer(index, size, type, normalized, stride, (const void *) offset);
+    }
+}
+
+void gls_attrib_divisor(GLuint index, GLuint divisor) {
+    if (changed(gls.divisor[index] != divisor)) {
+        gls.divisor[index] = divisor;
+        glVertexAttribDivisor(index, divisor);
+    }
+}
+
+void gls_attribs(unsigned mask) {
+    for (unsigned i = 0; i < GLS_MAX_ATTRIBS; i++) {
+        unsigned bit = 1u << i;
+        bool want = (mask & bit) != 0;
+        bool known = (gls.known & bit) != 0;
+        bool have = (gls.enabled & bit) != 0;
+        if (want) {
+            if (changed(!known || !have))
+                glEnableVertexAttribArray(i);
+        } else if (changed(!known || have)) {
+            glDisableVertexAttribArray(i);
+        }
+    }
+    gls.enabled = mask;
+    gls.known = (1u << GLS_MAX_ATTRIBS) - 1;
+}
+
+static void set_cap(GLenum cap, bool on) {
+    int *shadow = cap == GL_DEPTH_TEST ? &gls.depth_test : cap == GL_BLEND ? &gls.blend : NULL;
+    if (!shadow) {
+        gl_state_stats.issued++;
+        on ? glEnable(cap) : glDisable(cap);
+        return;
+    }
+    if (changed(*shadow != (int) on)) {
+        *shadow = on;
+        on ? glEnable(cap) : glDisable(cap);
+    }
+}
+
+void gls_enable(GLenum cap) {
+    set_cap(cap, true);
+}
+
+void gls_disable(GLenum cap) {
+    set_cap(cap, false);
+}
+
+void gls_depth_func(GLenum func) {
+    if (changed(gls.depth_func != func)) {
+        gls.depth_func = func;
+        glDepthFunc(func);
+    }
+}
+
+void gls_depth_mask(GLboolean flag) {
+    if (changed(gls.depth_mask != (int) flag)) {
+        gls.depth_mask = flag;
+        glDepthMask(flag);
+    }
+}
+
+void gls_line_width(GLfloat width) {
+    if (changed(gls.line_width != width)) {
+        gls.line_width = width;
+        glLineWidth(width);
+    }
+}
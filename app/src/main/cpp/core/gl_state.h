@@ -0,0 +1,58 @@
+#ifndef U3D_CORE_GL_STATE_H
+#define U3D_CORE_GL_STATE_H
+
+#include "gles.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ================= GL STATE SHADOW =================
+ * All per-frame state changes go through these wrappers. Each one remembers what it last sent
+ * and drops calls that would not change anything, so passes can declare the state they need
+ * without caring what the previous pass left behind.
+ *
+ * The shadow starts out unknown (every first call is issued). Call gls_reset whenever GL state
+ * may have changed behind its back, e.g. after a context is created.
+ */
+
+#define GLS_MAX_ATTRIBS 8
+
+typedef struct {
+    uint64_t issued;   // calls forwarded to GL
+    uint64_t elided;   // calls dropped as no-ops
+} GlStateStats;
+
+extern GlStateStats gl_state_stats;
+
+void gls_reset();
+
+void gls_use_program(GLuint program);
+
+/* Attribute pointers, divisors and enables belong to the bound VAO, so changing it makes their
+ * shadow unknown again. Only call when gl_caps.vertex_arrays. */
+void gls_bind_vertex_array(GLuint array);
+
+/* GL_ARRAY_BUFFER and GL_ELEMENT_ARRAY_BUFFER (VAO state) are shadowed; other targets are
+ * passed through. */
+void gls_bind_buffer(GLenum target, GLuint buffer);
+
+/* glVertexAttribPointer from the currently bound array buffer; offset is in bytes. */
+void gls_attrib_pointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                        GLsizei stride, size_t offset);
+
+void gls_attrib_divisor(GLuint index, GLuint divisor);
+
+/* Enables exactly the attribute arrays in mask (bit i = location i) and disables the rest. */
+void gls_attribs(unsigned mask);
+
+/* Only GL_DEPTH_TEST and GL_BLEND are shadowed; other capabilities are passed through. */
+void gls_enable(GLenum cap);
+void gls_disable(GLenum cap);
+
+void gls_depth_func(GLenum func);
+
+void gls_depth_mask(GLboolean flag);
+
+void gls_line_width(GLfloat width);
+
+#endif //U3D_CORE_GL_STATE_H
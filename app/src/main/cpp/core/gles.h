@@ -0,0 +1,26 @@
+#ifndef U3D_CORE_GLES_H
+#define U3D_CORE_GLES_H
+
+/*
+ * Single include point for OpenGL ES. On Android this is the NDK ES3 header (a superset of ES2;
+ * ES3-only entry points are only called when gl_caps says the context supports them). Everywhere
+ * else the core is linked against a recording stub (see bench/gles_stub.cpp) so it can be built
+ * and profiled on a plain Linux host.
+ */
+#ifdef __ANDROID__
+#include <EGL/egl.h>
+#include <GLES3/gl3.h>
+
+/* Extension entry points (e.g. the OES_vertex_array_object functions on ES2). */
+static inline void *gles_proc_address(const char *name) {
+    return (void *) eglGetProcAddress(name);
+}
+#else
+#include "gles_stub.h"
+
+static inline void *gles_proc_address(const char *name) {
+    return gl_stub_proc_address(name);
+}
+#endif
+
+#endif //U3D_CORE_GLES_H
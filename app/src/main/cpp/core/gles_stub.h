@@ -0,0 +1,188 @@
+#ifndef U3D_CORE_GLES_STUB_H
+#define U3D_CORE_GLES_STUB_H
+
+/*
+ * Host-side stand-in for <GLES3/gl3.h>. Only the subset of the API the core uses is declared.
+ * The definitions in bench/gles_stub.cpp do no rendering; they hand out object names and count
+ * calls so the benchmark can report submission cost.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned int  GLenum;
+typedef unsigned int  GLuint;
+typedef int           GLint;
+typedef int           GLsizei;
+typedef float         GLfloat;
+typedef unsigned char GLboolean;
+typedef unsigned int  GLbitfield;
+typedef char          GLchar;
+typedef unsigned char GLubyte;
+typedef void          GLvoid;
+typedef intptr_t      GLintptr;
+typedef intptr_t      GLsizeiptr;
+
+#define GL_APIENTRY
+
+#define GL_FALSE                 0
+#define GL_TRUE                  1
+
+#define GL_LINES                 0x0001
+#define GL_MAP_WRITE_BIT         0x0002
+#define GL_TRIANGLES             0x0004
+#define GL_MAP_INVALIDATE_BUFFER_BIT 0x0008
+#define GL_DEPTH_BUFFER_BIT      0x00000100
+#define GL_LESS                  0x0201
+#define GL_LEQUAL                0x0203
+#define GL_SRC_ALPHA             0x0302
+#define GL_ONE_MINUS_SRC_ALPHA   0x0303
+#define GL_COLOR_BUFFER_BIT      0x00004000
+#define GL_DEPTH_TEST            0x0B71
+#define GL_BLEND                 0x0BE2
+#define GL_UNPACK_ALIGNMENT      0x0CF5
+#define GL_TEXTURE_2D            0x0DE1
+#define GL_BYTE                  0x1400
+#define GL_UNSIGNED_BYTE         0x1401
+#define GL_UNSIGNED_SHORT        0x1403
+#define GL_FLOAT                 0x1406
+#define GL_HALF_FLOAT            0x140B
+#define GL_RGBA                  0x1908
+#define GL_VENDOR                0x1F00
+#define GL_RENDERER              0x1F01
+#define GL_VERSION               0x1F02
+#define GL_EXTENSIONS            0x1F03
+#define GL_NEAREST               0x2600
+#define GL_LINEAR                0x2601
+#define GL_LINEAR_MIPMAP_LINEAR  0x2703
+#define GL_TEXTURE_MAG_FILTER    0x2800
+#define GL_TEXTURE_MIN_FILTER    0x2801
+#define GL_TEXTURE_WRAP_S        0x2802
+#define GL_TEXTURE_WRAP_T        0x2803
+#define GL_RGBA8                 0x8058
+#define GL_CLAMP_TO_EDGE         0x812F
+#define GL_ARRAY_BUFFER          0x8892
+#define GL_ELEMENT_ARRAY_BUFFER  0x8893
+#define GL_STREAM_DRAW           0x88E0
+#define GL_STATIC_DRAW           0x88E4
+#define GL_DYNAMIC_DRAW          0x88E8
+#define GL_PIXEL_UNPACK_BUFFER   0x88EC
+#define GL_FRAGMENT_SHADER       0x8B30
+#define GL_VERTEX_SHADER         0x8B31
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#define GL_COMPILE_STATUS        0x8B81
+#define GL_LINK_STATUS           0x8B82
+#define GL_INFO_LOG_LENGTH       0x8B84
+#define GL_SRGB8_ALPHA8          0x8C43
+#define GL_INT_2_10_10_10_REV    0x8D9F
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#define GL_COMPRESSED_RGB8_ETC2  0x9274
+#define GL_COMPRESSED_SRGB8_ETC2 0x9275
+#define GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2  0x9276
+#define GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2 0x9277
+#define GL_COMPRESSED_RGBA8_ETC2_EAC        0x9278
+#define GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC 0x9279
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void   glAttachShader(GLuint program, GLuint shader);
+void   glBindAttribLocation(GLuint program, GLuint index, const GLchar *name);
+void   glBindBuffer(GLenum target, GLuint buffer);
+void   glBindTexture(GLenum target, GLuint texture);
+void   glBindVertexArray(GLuint array);
+void   glBlendFunc(GLenum sfactor, GLenum dfactor);
+void   glBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage);
+void   glClear(GLbitfield mask);
+void   glClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a);
+void   glCompileShader(GLuint shader);
+void   glCompressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset,
+                                 GLsizei width, GLsizei height, GLenum format, GLsizei imageSize,
+                                 const void *data);
+GLuint glCreateProgram(void);
+GLuint glCreateShader(GLenum type);
+void   glDeleteProgram(GLuint program);
+void   glDeleteShader(GLuint shader);
+void   glDeleteTextures(GLsizei n, const GLuint *textures);
+void   glDepthFunc(GLenum func);
+void   glDepthMask(GLboolean flag);
+void   glDisable(GLenum cap);
+void   glDisableVertexAttribArray(GLuint index);
+void   glDrawArrays(GLenum mode, GLint first, GLsizei count);
+void   glDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount);
+void   glDrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices);
+void   glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void *indices,
+                               GLsizei instancecount);
+void   glEnable(GLenum cap);
+void   glEnableVertexAttribArray(GLuint index);
+void   glGenBuffers(GLsizei n, GLuint *buffers);
+void   glGenerateMipmap(GLenum target);
+void   glGenTextures(GLsizei n, GLuint *textures);
+void   glGenVertexArrays(GLsizei n, GLuint *arrays);
+const GLubyte *glGetString(GLenum name);
+void   glGetIntegerv(GLenum pname, GLint *data);
+void   glGetProgramBinary(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat,
+                          void *binary);
+void   glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog);
+void   glGetProgramiv(GLuint program, GLenum pname, GLint *params);
+void   glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog);
+void   glGetShaderiv(GLuint shader, GLenum pname, GLint *params);
+GLint  glGetUniformLocation(GLuint program, const GLchar *name);
+void   glLineWidth(GLfloat width);
+void   glLinkProgram(GLuint program);
+void  *glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+void   glProgramBinary(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length);
+void   glProgramParameteri(GLuint program, GLenum pname, GLint value);
+void   glMaxShaderCompilerThreadsKHR(GLuint count);
+void   glShaderSource(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length);
+void   glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                    GLint border, GLenum format, GLenum type, const void *pixels);
+void   glTexParameteri(GLenum target, GLenum pname, GLint param);
+void   glTexStorage2D(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width,
+                      GLsizei height);
+void   glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width,
+                       GLsizei height, GLenum format, GLenum type, const void *pixels);
+void   glUniform1f(GLint location, GLfloat v0);
+void   glUniform2f(GLint location, GLfloat v0, GLfloat v1);
+void   glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value);
+GLboolean glUnmapBuffer(GLenum target);
+void   glUseProgram(GLuint program);
+void   glVertexAttribDivisor(GLuint index, GLuint divisor);
+void   glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+                             GLsizei stride, const void *pointer);
+void   glViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+/* ===== STUB INSTRUMENTATION ===== */
+
+typedef struct {
+    uint64_t calls;         // every GL entry point
+    uint64_t draw_calls;    // glDraw*
+    uint64_t state_calls;   // program/buffer/attribute/capability changes
+    uint64_t uniform_calls; // glUniform*
+} GlStubStats;
+
+extern GlStubStats gl_stub_stats;
+
+void gl_stub_reset_stats(void);
+
+/* GL_VERSION string the stub reports, e.g. "OpenGL ES 2.0" to exercise fallback paths. */
+void gl_stub_set_version(const char *version);
+
+/* GL_EXTENSIONS string the stub reports (space separated). */
+void gl_stub_set_extensions(const char *extensions);
+
+/* Completion queries (GL_COMPLETION_STATUS_KHR) a program answers false to before its link
+ * counts as finished, standing in for a driver compiling in the background. Default 0. */
+void gl_stub_set_link_polls(int polls);
+
+/* eglGetProcAddress stand-in: resolves the extension entry points the stub implements. */
+void *gl_stub_proc_address(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //U3D_CORE_GLES_STUB_H
@@ -0,0 +1,235 @@
+#include "input.h"
+#include "agents.h"
+#include "camera.h"
+#include "config.h"
+#include "ecs.h"
+#include "engine.h"
+#include "pacing.h"
+#include "pick.h"
+#include "spatial.h"
+
+#include <math.h>
+
+static bool hit_box(float x, float y, float bx, float by) {
+    return fabsf(x - bx) < LOCK_SIZE && fabsf(y - by) < LOCK_SIZE;
+}
+
+static bool hit_circle(float x, float y, float cx, float cy, float r) {
+    float dx = x - cx;
+    float dy = y - cy;
+    return (dx * dx + dy * dy) <= (r * r);
+}
+
+/* Where the grabbed entity's root should go for a touch at NDC (nx, ny): the touch ray meets a
+ * horizontal plane through the grab point, or for Y-axis drags a vertical plane through it
+ * facing the camera. (x, y, z) is the entity's current root. */
+static bool drag_target(float nx, float ny, float x, float y, float z, float out[3]) {
+    float origin[3], dir[3], t;
+    pick_ray_from_ndc(nx, ny, origin, dir);
+
+    float p[3] = {x - engine.grab_offset[0], y - engine.grab_offset[1], z - engine.grab_offset[2]};
+    float n[3] = {0.0f, 1.0f, 0.0f};
+
+    if (engine.active_axis == 1) {
+        const float *eye = frame_constants.eye;
+        float fx = eye[0] - p[0], fz = eye[2] - p[2];
+        float len = sqrtf(fx * fx + fz * fz);
+        if (len < 1e-4f)
+            return false;
+        n[0] = fx / len;
+        n[1] = 0.0f;
+        n[2] = fz / len;
+    }
+
+    /* grazing rays would throw the entity toward the horizon */
+    if (!ray_plane(origin, dir, p, n, &t) || t > CAM_FAR)
+        return false;
+
+    for (int a = 0; a < 3; a++)
+        out[a] = origin[a] + dir[a] * t + engine.grab_offset[a];
+    return true;
+}
+
+int input_touch(const TouchEvent *e) {
+    frame_invalidate();
+
+    float x = e->x[0];
+    float y = e->y[0];
+
+    engine.cursor_ndc_x = (x / engine.width) * 2.0f - 1.0f;
+    engine.cursor_ndc_y = 1.0f - (y / engine.height) * 2.0f;
+
+    float cx = engine.cursor_ndc_x;
+    float cy = engine.cursor_ndc_y;
+
+    int pointers = e->pointer_count;
+    int action   = e->action;
+
+/* ================= TWO-FINGER CAMERA CONTROL ================= */
+    if (pointers == 2) {
+        float x0 = e->x[0];
+        float y0 = e->y[0];
+        float x1 = e->x[1];
+        float y1 = e->y[1];
+
+        /* Pinch distance */
+        float dx = x0 - x1;
+        float dy = y0 - y1;
+        float dist = sqrtf(dx*dx + dy*dy);
+
+        /* Centroid (screen space) */
+        float cx2 = (x0 + x1) * 0.5f;
+        float cy2 = (y0 + y1) * 0.5f;
+
+        if (action == TOUCH_POINTER_DOWN) {
+            engine.pinch_start_dist  = dist;
+            engine.pinch_start_cam_z = engine.cam_z;
+            engine.pinch_last_cx     = cx2;
+            engine.pinch_last_cy     = cy2;
+            return 1;
+        }
+
+        if (action == TOUCH_MOVE && engine.pinch_start_dist > 0.0f) {
+            /* ----- ZOOM ----- */
+            float zoom_delta = dist - engine.pinch_start_dist;
+            engine.cam_z = engine.pinch_start_cam_z + zoom_delta * 0.015f;
+
+            if (engine.cam_z > -2.0f)  engine.cam_z = -2.0f;
+            if (engine.cam_z < -40.0f) engine.cam_z = -40.0f;
+
+            /* ----- ROTATE ----- */
+            float dxc = cx2 - engine.pinch_last_cx;
+            float dyc = cy2 - engine.pinch_last_cy;
+
+            float rot_sens = 0.0055f;
+
+            if (!engine.lock_cam_x)
+                engine.cam_yaw   += dxc * rot_sens;
+
+            if (!engine.lock_cam_y)
+                engine.cam_pitch += dyc * rot_sens;
+
+            /* Clamp pitch */
+            if (engine.cam_pitch > 1.4f)  engine.cam_pitch = 1.4f;
+            if (engine.cam_pitch < -1.4f) engine.cam_pitch = -1.4f;
+
+            engine.pinch_last_cx = cx2;
+            engine.pinch_last_cy = cy2;
+
+            return 1;
+        }
+    }
+
+    if (action == TOUCH_DOWN) {
+        /* ===== AXIS BUTTON TOGGLE ===== */
+        for (int i = 0; i < 3; i++) {
+            float bx = AXIS_BTN_START_X + i * AXIS_BTN_SPACING;
+            float by = AXIS_BTN_Y;
+
+            if (hit_circle(cx, cy, bx, by, AXIS_BTN_RADIUS)) {
+                engine.active_axis = (engine.active_axis == i) ? -1 : i;
+                return 1; // consume touch
+            }
+        }
+
+        /* ---- CAMERA LOCKS ---- */
+        if (hit_box(cx, cy, CAM_LOCK_START_X + 0*LOCK_SPACING, LOCK_Y))
+            engine.lock_cam_x = !engine.lock_cam_x;
+
+        if (hit_box(cx, cy, CAM_LOCK_START_X + 1*LOCK_SPACING, LOCK_Y))
+            engine.lock_cam_y = !engine.lock_cam_y;
+
+        if (hit_box(cx, cy, CAM_LOCK_START_X + 2*LOCK_SPACING, LOCK_Y))
+            engine.lock_cam_z = !engine.lock_cam_z;
+
+        /* ---- OBJECT LOCKS ---- */
+        if (hit_box(cx, cy, OBJ_LOCK_START_X + 0*LOCK_SPACING, LOCK_Y))
+            engine.lock_obj_x = !engine.lock_obj_x;
+
+        if (hit_box(cx, cy, OBJ_LOCK_START_X + 1*LOCK_SPACING, LOCK_Y))
+            engine.lock_obj_y = !engine.lock_obj_y;
+
+        if (hit_box(cx, cy, OBJ_LOCK_START_X + 2*LOCK_SPACING, LOCK_Y))
+            engine.lock_obj_z = !engine.lock_obj_z;
+    }
+
+    if (action == TOUCH_DOWN || (action == TOUCH_MOVE && engine.grabbed != ENTITY_NONE))
+        frame_constants_update();   // rays must see this event's camera, not last frame's
+
+    if (action == TOUCH_DOWN) {
+        engine.selected = ENTITY_NONE;
+        engine.grabbed  = ENTITY_NONE;
+
+        float origin[3], dir[3], t;
+        pick_ray_from_ndc(cx, cy, origin, dir);
+        Entity hit = pick_ray(origin, dir, &t, NULL);
+
+        int row;
+        EcsChunk *c = ecs_chunk_of(hit, &row);
+        if (c) {
+            engine.selected = hit;
+            engine.grabbed  = hit;
+            engine.last_x   = x;
+            engine.last_y   = y;
+
+            /* keep the touched point under the finger rather than snapping the root to it */
+            engine.grab_offset[0] = c->field[FIELD_X][row] - (origin[0] + dir[0] * t);
+            engine.grab_offset[1] = c->field[FIELD_Y][row] - (origin[1] + dir[1] * t);
+            engine.grab_offset[2] = c->field[FIELD_Z][row] - (origin[2] + dir[2] * t);
+        }
+    }
+
+    int row;
+    EcsChunk *g = ecs_chunk_of(engine.grabbed, &row);
+
+    if (action == TOUCH_MOVE && g) {
+        float dx = x - engine.last_x;
+        engine.last_x = x;
+
+        float *px = &g->field[FIELD_X][row];
+        float *py = &g->field[FIELD_Y][row];
+        float *pz = &g->field[FIELD_Z][row];
+
+        float target[3];
+        if (drag_target(cx, cy, *px, *py, *pz, target)) {
+            /* ===== AXIS-CONSTRAINED MOVE ===== */
+            if (engine.active_axis == -1) {
+                if (!engine.lock_obj_x) *px = target[0];
+                if (!engine.lock_obj_y) *py = target[1];
+                if (!engine.lock_obj_z) *pz = target[2];
+            } else {
+                if (engine.active_axis == 0 && !engine.lock_obj_x)
+                    *px = target[0];
+
+                if (engine.active_axis == 1 && !engine.lock_obj_y)
+                    *py = target[1];
+
+                if (engine.active_axis == 2 && !engine.lock_obj_z)
+                    *pz = target[2];
+            }
+
+            spatial_update(engine.grabbed, *px, *py, *pz);
+            agent_snap_history(engine.grabbed);
+        }
+
+        if (g->field[FIELD_ROT_VEL])
+            g->field[FIELD_ROT_VEL][row] += dx * (ROT_SENS * 0.35f);
+    }
+
+    if (g && g->field[FIELD_ROT_VEL]) {
+        float *rot_vel = &g->field[FIELD_ROT_VEL][row];
+        if (*rot_vel > 0.08f)
+            *rot_vel = 0.08f;
+
+        if (*rot_vel < -0.08f)
+            *rot_vel = -0.08f;
+    }
+
+    if (action == TOUCH_UP) {
+        engine.joyL_active = false;
+        engine.joyL_x = engine.joyL_y = 0.0f;
+        engine.grabbed = ENTITY_NONE;
+        engine.pinch_start_dist = 0.0f;
+    }
+    return 1;
+}
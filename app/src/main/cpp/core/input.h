@@ -0,0 +1,31 @@
+#ifndef U3D_CORE_INPUT_H
+#define U3D_CORE_INPUT_H
+
+/* ================= INPUT =================
+ * Platform-neutral touch event. The Android glue translates AInputEvent motion events into this;
+ * the host benchmark synthesizes them directly.
+ */
+
+enum TouchAction {
+    TOUCH_DOWN,
+    TOUCH_UP,
+    TOUCH_MOVE,
+    TOUCH_CANCEL,
+    TOUCH_POINTER_DOWN,
+    TOUCH_POINTER_UP,
+    TOUCH_OTHER
+};
+
+#define TOUCH_MAX_POINTERS 2
+
+typedef struct {
+    int   action;        // TouchAction
+    int   pointer_count; // total pointers down, may exceed TOUCH_MAX_POINTERS
+    float x[TOUCH_MAX_POINTERS];
+    float y[TOUCH_MAX_POINTERS];
+} TouchEvent;
+
+/* Applies a touch to camera, UI and agent state. Returns 1 if the event was consumed. */
+int input_touch(const TouchEvent *e);
+
+#endif //U3D_CORE_INPUT_H
@@ -0,0 +1,376 @@
+#include "jobs.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#define DEQUE_SIZE   4096   // power of two; a full deque runs the job inline instead
+#define JOB_POOL     4096   // per thread; a slot is reused only once its job has run
+#define SPIN_ROUNDS  64     // failed steal rounds before a worker sleeps
+
+typedef struct Job {
+    void (*run)(struct Job *job);
+    void *ctx;
+    void (*range_fn)(void *ctx, int begin, int end);
+    int begin, end;
+    std::atomic<int> *done;   // parallel_for: pieces left
+    std::atomic<bool> busy;   // from job_alloc until the job has run, on whichever thread
+} Job;
+
+/* ================= CHASE-LEV DEQUE =================
+ * The owner pushes and pops at the bottom (LIFO, cache-warm); thieves take from the top with a
+ * CAS. Orderings follow Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models",
+ * except that slots are published with release/acquire and the store-load on bottom and top that
+ * the paper orders with a seq_cst fence uses seq_cst accesses instead; thread sanitizers follow
+ * those but not standalone fences.
+ */
+
+typedef struct {
+    std::atomic<int64_t> top;
+    std::atomic<int64_t> bottom;
+    std::atomic<Job *>   slot[DEQUE_SIZE];
+} Deque;
+
+static bool deque_push(Deque *d, Job *job) {
+    int64_t b = d->bottom.load(std::memory_order_relaxed);
+    int64_t t = d->top.load(std::memory_order_acquire);
+    if (b - t >= DEQUE_SIZE)
+        return false;
+    d->slot[b & (DEQUE_SIZE - 1)].store(job, std::memory_order_release);
+    d->bottom.store(b + 1, std::memory_order_release);
+    return true;
+}
+
+static Job *deque_pop(Deque *d) {
+    int64_t b = d->bottom.load(std::memory_order_relaxed) - 1;
+    d->bottom.store(b, std::memory_order_seq_cst);
+    int64_t t = d->top.load(std::memory_order_seq_cst);
+
+    if (t > b) {   // empty
+        d->bottom.store(b + 1, std::memory_order_relaxed);
+        return NULL;
+    }
+    Job *job = d->slot[b & (DEQUE_SIZE - 1)].load(std::memory_order_relaxed);
+    if (t == b) {  // last item: race the thieves for it
+        if (!d->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                            std::memory_order_relaxed))
+            job = NULL;
+        d->bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+static Job *deque_steal(Deque *d) {
+    int64_t t = d->top.load(std::memory_order_seq_cst);
+    int64_t b = d->bottom.load(std::memory_order_seq_cst);
+    if (t >= b)
+        return NULL;
+    Job *job = d->slot[t & (DEQUE_SIZE - 1)].load(std::memory_order_acquire);
+    if (!d->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                        std::memory_order_relaxed))
+        return NULL;
+    return job;
+}
+
+static bool deque_empty(Deque *d) {
+    return d->top.load(std::memory_order_acquire) >= d->bottom.load(std::memory_order_acquire);
+}
+
+/* ================= THREADS ================= */
+
+typedef struct {
+    Deque    deque;
+    Job      pool[JOB_POOL];
+    uint32_t next_job;        // owner only
+    uint32_t rng;             // owner only: victim selection
+} JobThread;
+
+static JobThread threads[JOBS_MAX_THREADS];
+static std::atomic<int> thread_count(0);   // slots handed out
+static thread_local int self = -1;
+
+static pthread_t       workers[JOBS_MAX_THREADS];
+static int             worker_count;
+static std::atomic<bool> running(false);
+
+static pthread_mutex_t sleep_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  sleep_wake = PTHREAD_COND_INITIALIZER;
+static std::atomic<int> sleepers(0);
+
+/* Slot of the calling thread; submitting threads other than the workers register lazily. NULL
+ * once all JOBS_MAX_THREADS slots are taken: that thread then runs its work inline. */
+static JobThread *current() {
+    if (self < 0) {
+        int n = thread_count.load(std::memory_order_relaxed);
+        do {
+            if (n == JOBS_MAX_THREADS)
+                return NULL;
+        } while (!thread_count.compare_exchange_weak(n, n + 1, std::memory_order_relaxed));
+        self = n;
+        threads[self].rng = 0x9E3779B9u * (uint32_t) (self + 1);
+    }
+    return &threads[self];
+}
+
+static Job *job_find(JobThread *t);
+
+/* Runs job and hands its slot back to the thread that allocated it. */
+static void job_run(Job *job) {
+    job->run(job);
+    job->busy.store(false, std::memory_order_release);
+}
+
+/* A free slot from t's pool, scanning on from the last one handed out. A queued or running job
+ * keeps its slot, so more jobs in flight than JOB_POOL (a parallel_for with more pieces) make
+ * the submitter help run jobs until one comes back, instead of overwriting a queued one. */
+static Job *job_alloc(JobThread *t) {
+    for (;;) {
+        for (int i = 0; i < JOB_POOL; i++) {
+            Job *job = &t->pool[t->next_job++ & (JOB_POOL - 1)];
+            if (!job->busy.load(std::memory_order_acquire)) {
+                job->busy.store(true, std::memory_order_relaxed);
+                return job;
+            }
+        }
+        if (Job *job = job_find(t))
+            job_run(job);
+        else
+            sched_yield();
+    }
+}
+
+static void job_submit(JobThread *t, Job *job) {
+    if (!deque_push(&t->deque, job)) {
+        job_run(job);
+        return;
+    }
+    if (sleepers.load(std::memory_order_seq_cst) > 0) {
+        pthread_mutex_lock(&sleep_lock);
+        pthread_cond_broadcast(&sleep_wake);
+        pthread_mutex_unlock(&sleep_lock);
+    }
+}
+
+/* Own deque first, then one sweep over the others starting at a random victim. */
+static Job *job_find(JobThread *t) {
+    Job *job = deque_pop(&t->deque);
+    if (job)
+        return job;
+
+    int n = thread_count.load(std::memory_order_acquire);
+    t->rng ^= t->rng << 13;
+    t->rng ^= t->rng >> 17;
+    t->rng ^= t->rng << 5;
+    int start = (int) (t->rng % (uint32_t) n);
+    for (int i = 0; i < n; i++) {
+        JobThread *victim = &threads[(start + i) % n];
+        if (victim != t && (job = deque_steal(&victim->deque)))
+            return job;
+    }
+    return NULL;
+}
+
+static bool any_work() {
+    int n = thread_count.load(std::memory_order_acquire);
+    for (int i = 0; i < n; i++)
+        if (!deque_empty(&threads[i].deque))
+            return true;
+    return false;
+}
+
+static void *worker_main(void *arg) {
+    self = (int) (intptr_t) arg;
+    JobThread *t = &threads[self];
+
+    int idle = 0;
+    while (running.load(std::memory_order_acquire)) {
+        if (Job *job = job_find(t)) {
+            job_run(job);
+            idle = 0;
+            continue;
+        }
+        if (++idle < SPIN_ROUNDS) {
+            sched_yield();
+            continue;
+        }
+
+        /* A submitter checks sleepers after pushing, and we check for work after announcing
+         * ourselves under the lock, so a wakeup cannot fall between the two. */
+        pthread_mutex_lock(&sleep_lock);
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        if (running.load(std::memory_order_acquire) && !any_work())
+            pthread_cond_wait(&sleep_wake, &sleep_lock);
+        sleepers.fetch_sub(1, std::memory_order_relaxed);
+        pthread_mutex_unlock(&sleep_lock);
+        idle = 0;
+    }
+    return NULL;
+}
+
+/* Runs jobs until *counter reaches zero, so a waiting thread is never idle while work is queued. */
+static void job_wait(JobThread *t, std::atomic<int> *counter) {
+    while (counter->load(std::memory_order_acquire) > 0) {
+        if (Job *job = job_find(t))
+            job_run(job);
+        else
+            sched_yield();
+    }
+}
+
+void jobs_init(int count) {
+    if (count < 0)
+        count = (int) sysconf(_SC_NPROCESSORS_ONLN) - 1;
+    if (count > JOBS_MAX_THREADS - 2)   // leave slots for the GL and sim threads
+        count = JOBS_MAX_THREADS - 2;
+    if (count <= 0 || running.load(std::memory_order_relaxed))
+        return;
+
+    /* workers take the next free slots, after any thread that already submitted */
+    int base = thread_count.load(std::memory_order_relaxed);
+    do {
+        if (count > JOBS_MAX_THREADS - base)
+            count = JOBS_MAX_THREADS - base;
+    } while (!thread_count.compare_exchange_weak(base, base + count, std::memory_order_acq_rel));
+    if (count <= 0)
+        return;
+
+    for (int i = 0; i < count; i++)
+        threads[base + i].rng = 0x9E3779B9u * (uint32_t) (base + i + 1);
+
+    worker_count = count;
+    running.store(true, std::memory_order_release);
+    for (int i = 0; i < count; i++)
+        pthread_create(&workers[i], NULL, worker_main, (void *) (intptr_t) (base + i));
+}
+
+void jobs_shutdown() {
+    if (!running.load(std::memory_order_relaxed))
+        return;
+    running.store(false, std::memory_order_release);
+    pthread_mutex_lock(&sleep_lock);
+    pthread_cond_broadcast(&sleep_wake);
+    pthread_mutex_unlock(&sleep_lock);
+    for (int i = 0; i < worker_count; i++)
+        pthread_join(workers[i], NULL);
+    worker_count = 0;
+}
+
+int jobs_worker_count() {
+    return worker_count;
+}
+
+/* ================= PARALLEL FOR ================= */
+
+static void run_range(Job *job) {
+    job->range_fn(job->ctx, job->begin, job->end);
+    job->done->fetch_sub(1, std::memory_order_release);
+}
+
+void parallel_for(int count, int grain, void (*fn)(void *ctx, int begin, int end), void *ctx) {
+    if (count <= 0)
+        return;
+    if (grain < 1)
+        grain = 1;
+
+    /* same pieces either way, so per-piece results never depend on the worker count */
+    JobThread *t = worker_count > 0 && count > grain ? current() : NULL;
+    if (!t) {
+        for (int b = 0; b < count; b += grain)
+            fn(ctx, b, b + grain < count ? b + grain : count);
+        return;
+    }
+
+    std::atomic<int> done((count + grain - 1) / grain);
+    for (int b = 0; b < count; b += grain) {
+        Job *job = job_alloc(t);
+        job->run = run_range;
+        job->ctx = ctx;
+        job->range_fn = fn;
+        job->begin = b;
+        job->end = b + grain < count ? b + grain : count;
+        job->done = &done;
+        job_submit(t, job);
+    }
+    job_wait(t, &done);
+}
+
+/* ================= TASK GRAPH ================= */
+
+static void run_node(Job *job) {
+    JobGraph *g = (JobGraph *) job->ctx;
+    JobNode *n = &g->node[job->begin];
+    n->fn(n->ctx);
+
+    JobThread *t = current();
+    for (int i = 0; i < n->successor_count; i++) {
+        int s = n->successors[i];
+        if (g->node[s].remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            Job *next = job_alloc(t);
+            next->run = run_node;
+            next->ctx = g;
+            next->begin = s;
+            job_submit(t, next);
+        }
+    }
+    g->pending.fetch_sub(1, std::memory_order_release);
+}
+
+int job_graph_add(JobGraph *g, void (*fn)(void *ctx), void *ctx) {
+    if (g->count == JOBS_MAX_NODES)
+        return -1;
+    JobNode *n = &g->node[g->count];
+    n->fn = fn;
+    n->ctx = ctx;
+    n->deps = 0;
+    n->successor_count = 0;
+    return g->count++;
+}
+
+bool job_graph_depend(JobGraph *g, int node, int on) {
+    if (node < 0 || node >= g->count || on < 0 || on >= g->count || node == on)
+        return false;
+    JobNode *before = &g->node[on];
+    if (before->successor_count == JOBS_MAX_SUCCESSORS)
+        return false;
+    before->successors[before->successor_count++] = node;
+    g->node[node].deps++;
+    return true;
+}
+
+void job_graph_run(JobGraph *g) {
+    JobThread *t = worker_count > 0 ? current() : NULL;
+    if (!t) {
+        /* inline: repeatedly run whatever is ready, in index order */
+        for (int i = 0; i < g->count; i++)
+            g->node[i].remaining.store(g->node[i].deps, std::memory_order_relaxed);
+        int left = g->count;
+        while (left > 0) {
+            for (int i = 0; i < g->count; i++) {
+                JobNode *n = &g->node[i];
+                if (n->remaining.load(std::memory_order_relaxed) != 0)
+                    continue;
+                n->remaining.store(-1, std::memory_order_relaxed);
+                n->fn(n->ctx);
+                for (int k = 0; k < n->successor_count; k++)
+                    g->node[n->successors[k]].remaining.fetch_sub(1, std::memory_order_relaxed);
+                left--;
+            }
+        }
+        return;
+    }
+
+    for (int i = 0; i < g->count; i++)
+        g->node[i].remaining.store(g->node[i].deps, std::memory_order_relaxed);
+    g->pending.store(g->count, std::memory_order_release);
+
+    for (int i = 0; i < g->count; i++) {
+        if (g->node[i].deps != 0)
+            continue;
+        Job *job = job_alloc(t);
+        job->run = run_node;
+        job->ctx = g;
+        job->begin = i;
+        job_submit(t, job);
+    }
+    job_wait(t, &g->pending);
+}
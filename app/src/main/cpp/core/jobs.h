@@ -0,0 +1,67 @@
+#ifndef U3D_CORE_JOBS_H
+#define U3D_CORE_JOBS_H
+
+#include <atomic>
+
+/* ================= JOB SYSTEM =================
+ * Fixed pool of worker threads, each with a Chase-Lev work-stealing deque. A thread that
+ * submits work pushes onto its own deque and keeps executing jobs (its own or stolen ones)
+ * while it waits, so nested parallel_for calls and graph nodes that fan out never deadlock.
+ *
+ * Results are deterministic regardless of the worker count: parallel_for always splits a
+ * range into the same grain-sized pieces, each piece writes only its own outputs, and anything
+ * combined across pieces must be order-independent (or combined by the caller in piece order).
+ *
+ * Any thread may submit (the GL thread and the sim thread both do); up to JOBS_MAX_THREADS
+ * threads including the workers get a deque, and any further submitting thread runs its work
+ * inline.
+ */
+
+#define JOBS_MAX_THREADS   16
+#define JOBS_MAX_NODES     32   // per JobGraph
+#define JOBS_MAX_SUCCESSORS 8   // per graph node
+
+/* Starts worker threads. workers < 0 picks one per online core minus the calling thread;
+ * 0 runs everything inline on the submitting thread. */
+void jobs_init(int workers);
+
+/* Stops and joins the workers; later submissions run inline. */
+void jobs_shutdown();
+
+int jobs_worker_count();
+
+/* Calls fn(ctx, begin, end) over [0, count) in pieces of grain items (the last may be shorter)
+ * and returns when all pieces are done. */
+void parallel_for(int count, int grain, void (*fn)(void *ctx, int begin, int end), void *ctx);
+
+/* ================= TASK GRAPH =================
+ * Nodes run once their dependencies have finished; independent nodes run in parallel. Build
+ * the graph once, then job_graph_run it as often as needed (e.g. once per sim step).
+ */
+
+typedef struct {
+    void (*fn)(void *ctx);
+    void *ctx;
+    int   deps;                              // dependencies, fixed at build time
+    int   successors[JOBS_MAX_SUCCESSORS];
+    int   successor_count;
+    std::atomic<int> remaining;              // unfinished dependencies during a run
+} JobNode;
+
+typedef struct {
+    JobNode node[JOBS_MAX_NODES];
+    int     count;
+    std::atomic<int> pending;                // nodes not yet finished during a run
+} JobGraph;
+
+/* Adds a node; returns its index, or -1 if the graph already has JOBS_MAX_NODES. */
+int job_graph_add(JobGraph *g, void (*fn)(void *ctx), void *ctx);
+
+/* node runs only after on has finished. false, and the graph unchanged, if either is not a node
+ * of g, they are the same node, or on already has JOBS_MAX_SUCCESSORS. */
+bool job_graph_depend(JobGraph *g, int node, int on);
+
+/* Runs every node respecting dependencies; returns when all have finished. */
+void job_graph_run(JobGraph *g);
+
+#endif //U3D_CORE_JOBS_H
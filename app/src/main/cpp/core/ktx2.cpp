@@ -0,0 +1,172 @@
+#include "ktx2.h"
+#include "gl_caps.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR         0x93B0
+#define GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR 0x93D0
+#endif
+
+#define KTX2_HEADER_SIZE 80   // identifier, header and index; the level index follows
+#define KTX2_LEVEL_SIZE  24   // byteOffset, byteLength, uncompressedByteLength
+
+static const uint8_t IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB,
+                                       '\r', '\n', 0x1A, '\n'};
+
+enum Family {
+    FAMILY_RGBA8,
+    FAMILY_ETC2,
+    FAMILY_ASTC
+};
+
+typedef struct {
+    uint32_t vk_format;
+    GLenum   internal_format;
+    int      block_width, block_height, block_bytes;
+    int      family;
+} Format;
+
+static const Format FORMATS[] = {
+        {37,  GL_RGBA8,                                     1, 1, 4,  FAMILY_RGBA8},
+        {43,  GL_SRGB8_ALPHA8,                              1, 1, 4,  FAMILY_RGBA8},
+        {147, GL_COMPRESSED_RGB8_ETC2,                      4, 4, 8,  FAMILY_ETC2},
+        {148, GL_COMPRESSED_SRGB8_ETC2,                     4, 4, 8,  FAMILY_ETC2},
+        {149, GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2,  4, 4, 8,  FAMILY_ETC2},
+        {150, GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2, 4, 4, 8,  FAMILY_ETC2},
+        {151, GL_COMPRESSED_RGBA8_ETC2_EAC,                 4, 4, 16, FAMILY_ETC2},
+        {152, GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC,          4, 4, 16, FAMILY_ETC2},
+};
+
+/* VK_FORMAT_ASTC_4x4_UNORM_BLOCK = 157 through 12x12_SRGB = 184, UNORM and SRGB alternating;
+ * the GL enums run through the same block sizes in the same order. */
+#define VK_ASTC_FIRST 157
+static const uint8_t ASTC_BLOCKS[14][2] = {{4, 4},  {5, 4},  {5, 5},   {6, 5},   {6, 6},
+                                           {8, 5},  {8, 6},  {8, 8},   {10, 5},  {10, 6},
+                                           {10, 8}, {10, 10}, {12, 10}, {12, 12}};
+
+static bool find_format(uint32_t vk_format, Format *format) {
+    for (size_t i = 0; i < sizeof(FORMATS) / sizeof(FORMATS[0]); i++) {
+        if (FORMATS[i].vk_format == vk_format) {
+            *format = FORMATS[i];
+            return true;
+        }
+    }
+    uint32_t astc = vk_format - VK_ASTC_FIRST;
+    if (vk_format < VK_ASTC_FIRST || astc >= 2 * 14)
+        return false;
+    bool srgb = astc & 1;
+    format->vk_format = vk_format;
+    format->internal_format = (srgb ? GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR
+                                    : GL_COMPRESSED_RGBA_ASTC_4x4_KHR) + astc / 2;
+    format->block_width = ASTC_BLOCKS[astc / 2][0];
+    format->block_height = ASTC_BLOCKS[astc / 2][1];
+    format->block_bytes = 16;
+    format->family = FAMILY_ASTC;
+    return true;
+}
+
+static int family(GLenum internal_format) {
+    if (internal_format >= GL_COMPRESSED_RGB8_ETC2 &&
+        internal_format <= GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC)
+        return FAMILY_ETC2;
+    if ((internal_format >= GL_COMPRESSED_RGBA_ASTC_4x4_KHR &&
+         internal_format < GL_COMPRESSED_RGBA_ASTC_4x4_KHR + 14) ||
+        (internal_format >= GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR &&
+         internal_format < GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR + 14))
+        return FAMILY_ASTC;
+    return FAMILY_RGBA8;
+}
+
+static uint32_t u32(const uint8_t *p) {
+    return (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 |
+           (uint32_t) p[3] << 24;
+}
+
+static uint64_t u64(const uint8_t *p) {
+    return (uint64_t) u32(p) | (uint64_t) u32(p + 4) << 32;
+}
+
+bool ktx2_is(const uint8_t *data, size_t size) {
+    return size >= sizeof(IDENTIFIER) && memcmp(data, IDENTIFIER, sizeof(IDENTIFIER)) == 0;
+}
+
+bool ktx2_parse(const uint8_t *data, size_t size, TextureImage *image, char *error,
+                size_t error_size) {
+    if (!ktx2_is(data, size) || size < KTX2_HEADER_SIZE) {
+        snprintf(error, error_size, "not a KTX2 file");
+        return false;
+    }
+
+    uint32_t vk_format = u32(data + 12);
+    uint32_t width = u32(data + 20), height = u32(data + 24), depth = u32(data + 28);
+    uint32_t layers = u32(data + 32), faces = u32(data + 36), levels = u32(data + 40);
+    uint32_t supercompression = u32(data + 44);
+
+    Format format;
+    if (!find_format(vk_format, &format)) {
+        snprintf(error, error_size, "unsupported KTX2 format %u", vk_format);
+        return false;
+    }
+    if (supercompression != 0) {
+        snprintf(error, error_size, "supercompressed KTX2 (scheme %u)", supercompression);
+        return false;
+    }
+    if (width == 0 || height == 0 || depth != 0 || layers > 1 || faces != 1) {
+        snprintf(error, error_size, "not a 2D KTX2 texture");
+        return false;
+    }
+    if (width > KTX2_MAX_SIZE || height > KTX2_MAX_SIZE) {
+        snprintf(error, error_size, "KTX2 texture too large");
+        return false;
+    }
+    if (levels == 0)
+        levels = 1;   // "generate mipmaps at load time"; compressed formats cannot
+    if (levels > TEXTURE_MAX_LEVELS || (levels > 1 && (width | height) >> (levels - 1) == 0) ||
+        size < KTX2_HEADER_SIZE + (size_t) levels * KTX2_LEVEL_SIZE) {
+        snprintf(error, error_size, "bad KTX2 level count %u", levels);
+        return false;
+    }
+
+    image->internal_format = format.internal_format;
+    image->width = (int) width;
+    image->height = (int) height;
+    image->block_width = format.block_width;
+    image->block_height = format.block_height;
+    image->block_bytes = format.block_bytes;
+    image->levels = (int) levels;
+    for (int level = 0; level < image->levels; level++) {
+        const uint8_t *index = data + KTX2_HEADER_SIZE + (size_t) level * KTX2_LEVEL_SIZE;
+        uint64_t offset = u64(index), length = u64(index + 8);
+        if (length != texture_level_size(image, level) || offset > size ||
+            length > size - offset) {
+            snprintf(error, error_size, "bad KTX2 level %d", level);
+            return false;
+        }
+        image->level[level] = data + offset;
+    }
+    return true;
+}
+
+bool ktx2_supported(const TextureImage *image) {
+    switch (family(image->internal_format)) {
+        case FAMILY_ETC2:
+            return gl_caps.etc2;
+        case FAMILY_ASTC:
+            return gl_caps.astc;
+        default:
+            return true;
+    }
+}
+
+const char *ktx2_format_name(GLenum internal_format) {
+    switch (family(internal_format)) {
+        case FAMILY_ETC2:
+            return "ETC2";
+        case FAMILY_ASTC:
+            return "ASTC";
+        default:
+            return "RGBA8";
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef U3D_CORE_KTX2_H
+#define U3D_CORE_KTX2_H
+
+#include "texture.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ================= KTX2 =================
+ * Khronos KTX 2.0 containers holding a 2D texture with its mip chain already built, in RGBA8 or
+ * a block-compressed format the GPU samples directly: ETC2/EAC (every ES3 device) or ASTC LDR.
+ * Parsing copies nothing: the TextureImage's levels point into the file, so a texture mapped
+ * from the APK goes to texture_submit_image straight from the page cache. Supercompressed
+ * files (Basis, zstd), arrays, cube maps and 3D textures are rejected.
+ */
+
+#define KTX2_MAX_SIZE 16384   // larger dimensions are a corrupt header
+
+/* Whether data starts with the KTX2 identifier. */
+bool ktx2_is(const uint8_t *data, size_t size);
+
+/* Fills image from the file in data, whose levels then point into it. False with a message in
+ * error if the file is malformed or holds something other than the above. */
+bool ktx2_parse(const uint8_t *data, size_t size, TextureImage *image, char *error,
+                size_t error_size);
+
+/* Whether the current context samples image's format (gl_caps; thread-safe once set). */
+bool ktx2_supported(const TextureImage *image);
+
+/* "ETC2", "ASTC" or "RGBA8", for messages. */
+const char *ktx2_format_name(GLenum internal_format);
+
+#endif //U3D_CORE_KTX2_H
@@ -0,0 +1,158 @@
+#include "mat4.h"
+#include "simd.h"
+
+#include <math.h>
+#include <string.h>
+
+void mat4_identity(float *m){ memset(m,0,64); m[0]=m[5]=m[10]=m[15]=1; }
+void mat4_translate(float *m,float x,float y,float z){ mat4_identity(m); m[12]=x; m[13]=y; m[14]=z; }
+void mat4_scale(float *m,float x,float y,float z){ mat4_identity(m); m[0]=x; m[5]=y; m[10]=z; }
+void mat4_rotate_y(float *m,float a){ mat4_identity(m); m[0]=cosf(a); m[2]=-sinf(a); m[8]=sinf(a); m[10]=cosf(a); }
+void mat4_rotate_x(float *m,float a){
+    mat4_identity(m);
+    m[5] = cosf(a);
+    m[6] = sinf(a);
+    m[9] = -sinf(a);
+    m[10]= cosf(a);
+}
+void mat4_perspective(float *m,float fov,float asp,float n,float f){
+    float t=tanf(fov*0.5f); memset(m,0,64);
+    m[0]=1/(asp*t); m[5]=1/t; m[10]=-(f+n)/(f-n); m[11]=-1; m[14]=-(2*f*n)/(f-n);
+}
+
+void mat4_translate_rotate_y(float *m, float x, float y, float z, float a) {
+    float c = cosf(a), s = sinf(a);
+    m[0] = c;  m[1] = 0; m[2]  = -s; m[3]  = 0;
+    m[4] = 0;  m[5] = 1; m[6]  = 0;  m[7]  = 0;
+    m[8] = s;  m[9] = 0; m[10] = c;  m[11] = 0;
+    m[12] = x; m[13] = y; m[14] = z; m[15] = 1;
+}
+
+/* ================= PRODUCTS =================
+ * Column c of a*b is a.col0*b[c][0] + a.col1*b[c][1] + a.col2*b[c][2] + a.col3*b[c][3], so each
+ * output column is four broadcast multiply-adds over the columns of a held in registers.
+ */
+
+static inline void mul_cols(float *o, f4 a0, f4 a1, f4 a2, f4 a3, const float *b) {
+    f4 r[4];
+    for (int c = 0; c < 4; c++) {
+        const float *bc = b + c * 4;
+        f4 v = f4_mul(a0, f4_splat(bc[0]));
+        v = f4_madd(a1, f4_splat(bc[1]), v);
+        v = f4_madd(a2, f4_splat(bc[2]), v);
+        v = f4_madd(a3, f4_splat(bc[3]), v);
+        r[c] = v;
+    }
+    for (int c = 0; c < 4; c++) f4_store(o + c * 4, r[c]);
+}
+
+/* With both bottom rows (0,0,0,1): columns 0-2 of b have no w term and column 3 adds a.col3. */
+static inline void mul_cols_affine(float *o, f4 a0, f4 a1, f4 a2, f4 a3, const float *b) {
+    f4 r[4];
+    for (int c = 0; c < 3; c++) {
+        const float *bc = b + c * 4;
+        f4 v = f4_mul(a0, f4_splat(bc[0]));
+        v = f4_madd(a1, f4_splat(bc[1]), v);
+        r[c] = f4_madd(a2, f4_splat(bc[2]), v);
+    }
+    f4 v = f4_madd(a0, f4_splat(b[12]), a3);
+    v = f4_madd(a1, f4_splat(b[13]), v);
+    r[3] = f4_madd(a2, f4_splat(b[14]), v);
+    for (int c = 0; c < 4; c++) f4_store(o + c * 4, r[c]);
+}
+
+void mat4_mul(float *o, const float *a, const float *b) {
+    mul_cols(o, f4_load(a), f4_load(a + 4), f4_load(a + 8), f4_load(a + 12), b);
+}
+
+void mat4_mul_affine(float *o, const float *a, const float *b) {
+    mul_cols_affine(o, f4_load(a), f4_load(a + 4), f4_load(a + 8), f4_load(a + 12), b);
+}
+
+void mat4_mul_many(float *o, const float *a, const float *b, int n) {
+    f4 a0 = f4_load(a), a1 = f4_load(a + 4), a2 = f4_load(a + 8), a3 = f4_load(a + 12);
+    for (int i = 0; i < n; i++)
+        mul_cols(o + i * 16, a0, a1, a2, a3, b + i * 16);
+}
+
+void mat4_mul_affine_many(float *o, const float *a, const float *b, int n) {
+    f4 a0 = f4_load(a), a1 = f4_load(a + 4), a2 = f4_load(a + 8), a3 = f4_load(a + 12);
+    for (int i = 0; i < n; i++)
+        mul_cols_affine(o + i * 16, a0, a1, a2, a3, b + i * 16);
+}
+
+void mat4_transform_points(float *out, const float *m, const float *in, int n) {
+    f4 m0 = f4_load(m), m1 = f4_load(m + 4), m2 = f4_load(m + 8), m3 = f4_load(m + 12);
+    float r[4];
+    for (int i = 0; i < n; i++) {
+        const float *p = in + i * 3;
+        f4 v = f4_madd(m0, f4_splat(p[0]), m3);
+        v = f4_madd(m1, f4_splat(p[1]), v);
+        v = f4_madd(m2, f4_splat(p[2]), v);
+        f4_store(r, v);
+        memcpy(out + i * 3, r, 3 * sizeof(float));
+    }
+}
+
+/* ================= INVERSES ================= */
+
+bool mat4_inverse(float *o, const float *m) {
+    float inv[16];
+
+    inv[0]  =  m[5]*m[10]*m[15] - m[5]*m[11]*m[14] - m[9]*m[6]*m[15] + m[9]*m[7]*m[14] + m[13]*m[6]*m[11] - m[13]*m[7]*m[10];
+    inv[4]  = -m[4]*m[10]*m[15] + m[4]*m[11]*m[14] + m[8]*m[6]*m[15] - m[8]*m[7]*m[14] - m[12]*m[6]*m[11] + m[12]*m[7]*m[10];
+    inv[8]  =  m[4]*m[9]*m[15]  - m[4]*m[11]*m[13] - m[8]*m[5]*m[15] + m[8]*m[7]*m[13] + m[12]*m[5]*m[11] - m[12]*m[7]*m[9];
+    inv[12] = -m[4]*m[9]*m[14]  + m[4]*m[10]*m[13] + m[8]*m[5]*m[14] - m[8]*m[6]*m[13] - m[12]*m[5]*m[10] + m[12]*m[6]*m[9];
+    inv[1]  = -m[1]*m[10]*m[15] + m[1]*m[11]*m[14] + m[9]*m[2]*m[15] - m[9]*m[3]*m[14] - m[13]*m[2]*m[11] + m[13]*m[3]*m[10];
+    inv[5]  =  m[0]*m[10]*m[15] - m[0]*m[11]*m[14] - m[8]*m[2]*m[15] + m[8]*m[3]*m[14] + m[12]*m[2]*m[11] - m[12]*m[3]*m[10];
+    inv[9]  = -m[0]*m[9]*m[15]  + m[0]*m[11]*m[13] + m[8]*m[1]*m[15] - m[8]*m[3]*m[13] - m[12]*m[1]*m[11] + m[12]*m[3]*m[9];
+    inv[13] =  m[0]*m[9]*m[14]  - m[0]*m[10]*m[13] - m[8]*m[1]*m[14] + m[8]*m[2]*m[13] + m[12]*m[1]*m[10] - m[12]*m[2]*m[9];
+    inv[2]  =  m[1]*m[6]*m[15]  - m[1]*m[7]*m[14]  - m[5]*m[2]*m[15] + m[5]*m[3]*m[14] + m[13]*m[2]*m[7]  - m[13]*m[3]*m[6];
+    inv[6]  = -m[0]*m[6]*m[15]  + m[0]*m[7]*m[14]  + m[4]*m[2]*m[15] - m[4]*m[3]*m[14] - m[12]*m[2]*m[7]  + m[12]*m[3]*m[6];
+    inv[10] =  m[0]*m[5]*m[15]  - m[0]*m[7]*m[13]  - m[4]*m[1]*m[15] + m[4]*m[3]*m[13] + m[12]*m[1]*m[7]  - m[12]*m[3]*m[5];
+    inv[14] = -m[0]*m[5]*m[14]  + m[0]*m[6]*m[13]  + m[4]*m[1]*m[14] - m[4]*m[2]*m[13] - m[12]*m[1]*m[6]  + m[12]*m[2]*m[5];
+    inv[3]  = -m[1]*m[6]*m[11]  + m[1]*m[7]*m[10]  + m[5]*m[2]*m[11] - m[5]*m[3]*m[10] - m[9]*m[2]*m[7]   + m[9]*m[3]*m[6];
+    inv[7]  =  m[0]*m[6]*m[11]  - m[0]*m[7]*m[10]  - m[4]*m[2]*m[11] + m[4]*m[3]*m[10] + m[8]*m[2]*m[7]   - m[8]*m[3]*m[6];
+    inv[11] = -m[0]*m[5]*m[11]  + m[0]*m[7]*m[9]   + m[4]*m[1]*m[11] - m[4]*m[3]*m[9]  - m[8]*m[1]*m[7]   + m[8]*m[3]*m[5];
+    inv[15] =  m[0]*m[5]*m[10]  - m[0]*m[6]*m[9]   - m[4]*m[1]*m[10] + m[4]*m[2]*m[9]  + m[8]*m[1]*m[6]   - m[8]*m[2]*m[5];
+
+    float det = m[0]*inv[0] + m[1]*inv[4] + m[2]*inv[8] + m[3]*inv[12];
+    if (det == 0.0f)
+        return false;
+
+    det = 1.0f / det;
+    for (int i = 0; i < 16; i++) o[i] = inv[i] * det;
+    return true;
+}
+
+bool mat4_inverse_affine(float *o, const float *m) {
+    /* cofactors of the upper 3x3 (columns a, b, c) */
+    float c00 = m[5]*m[10] - m[6]*m[9];
+    float c01 = m[6]*m[8]  - m[4]*m[10];
+    float c02 = m[4]*m[9]  - m[5]*m[8];
+    float det = m[0]*c00 + m[1]*c01 + m[2]*c02;
+    if (det == 0.0f)
+        return false;
+    float id = 1.0f / det;
+
+    float r[16];
+    r[0]  = c00 * id;
+    r[1]  = (m[2]*m[9]  - m[1]*m[10]) * id;
+    r[2]  = (m[1]*m[6]  - m[2]*m[5])  * id;
+    r[3]  = 0.0f;
+    r[4]  = c01 * id;
+    r[5]  = (m[0]*m[10] - m[2]*m[8])  * id;
+    r[6]  = (m[2]*m[4]  - m[0]*m[6])  * id;
+    r[7]  = 0.0f;
+    r[8]  = c02 * id;
+    r[9]  = (m[1]*m[8]  - m[0]*m[9])  * id;
+    r[10] = (m[0]*m[5]  - m[1]*m[4])  * id;
+    r[11] = 0.0f;
+    r[12] = -(r[0]*m[12] + r[4]*m[13] + r[8]*m[14]);
+    r[13] = -(r[1]*m[12] + r[5]*m[13] + r[9]*m[14]);
+    r[14] = -(r[2]*m[12] + r[6]*m[13] + r[10]*m[14]);
+    r[15] = 1.0f;
+
+    memcpy(o, r, sizeof(r));
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef U3D_CORE_MAT4_H
+#define U3D_CORE_MAT4_H
+
+/* ================= MATH =================
+ * Column-major 4x4 matrices stored as float[16], matching what glUniformMatrix4fv expects.
+ * Products are vectorized (see simd.h) and safe to call with the output aliasing an input.
+ *
+ * "Affine" entry points assume the bottom row of every operand is (0, 0, 0, 1), i.e. only
+ * translation/rotation/scale. They skip that row and are what per-object transforms should use;
+ * keep the general versions for anything involving a projection.
+ */
+
+void mat4_identity(float *m);
+void mat4_translate(float *m, float x, float y, float z);
+void mat4_scale(float *m, float x, float y, float z);
+void mat4_rotate_y(float *m, float a);
+void mat4_rotate_x(float *m, float a);
+void mat4_perspective(float *m, float fov, float asp, float n, float f);
+
+/* translate(x, y, z) * rotate_y(a), built directly. */
+void mat4_translate_rotate_y(float *m, float x, float y, float z, float a);
+
+/* o = a * b */
+void mat4_mul(float *o, const float *a, const float *b);
+void mat4_mul_affine(float *o, const float *a, const float *b);
+
+/* o[i] = a * b[i] for n matrices packed 16 floats apart. a stays in registers for the batch. */
+void mat4_mul_many(float *o, const float *a, const float *b, int n);
+void mat4_mul_affine_many(float *o, const float *a, const float *b, int n);
+
+/* o = inverse(m). Returns false (and leaves o untouched) if m is singular. */
+bool mat4_inverse(float *o, const float *m);
+
+/* Inverse of an affine m: inverts the upper 3x3 and back-transforms the translation. */
+bool mat4_inverse_affine(float *o, const float *m);
+
+/* out[i] = m * (in[i], 1) for n points packed as xyz triples; m must be affine. */
+void mat4_transform_points(float *out, const float *m, const float *in, int n);
+
+#endif //U3D_CORE_MAT4_H
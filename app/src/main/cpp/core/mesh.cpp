@@ -0,0 +1,334 @@
+#include "mesh.h"
+#include "gl_caps.h"
+#include "gl_state.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+MeshStats mesh_stats;
+
+/* ================= PACKING ================= */
+
+/* Round to nearest even; overflow goes to infinity (the tolerance check rejects it). */
+static uint16_t float_to_half(float f) {
+    uint32_t x;
+    memcpy(&x, &f, 4);
+    uint32_t sign = (x >> 16) & 0x8000;
+    uint32_t mant = x & 0x7FFFFF;
+    int exp = (int) ((x >> 23) & 0xFF) - 127 + 15;
+
+    if (((x >> 23) & 0xFF) == 0xFF)
+        return (uint16_t) (sign | 0x7C00 | (mant ? 0x200 : 0));
+    if (exp >= 31)
+        return (uint16_t) (sign | 0x7C00);
+    if (exp <= 0) {   // subnormal
+        if (exp < -10)
+            return (uint16_t) sign;
+        mant |= 0x800000;
+        int shift = 14 - exp;
+        uint32_t h = mant >> shift;
+        uint32_t rem = mant & ((1u << shift) - 1), half = 1u << (shift - 1);
+        if (rem > half || (rem == half && (h & 1)))
+            h++;
+        return (uint16_t) (sign | h);
+    }
+    uint32_t h = ((uint32_t) exp << 10) | (mant >> 13);
+    uint32_t rem = mant & 0x1FFF;
+    if (rem > 0x1000 || (rem == 0x1000 && (h & 1)))
+        h++;   // a carry into the exponent is still the right value
+    return (uint16_t) (sign | h);
+}
+
+static float half_to_float(uint16_t h) {
+    int exp = (h >> 10) & 0x1F;
+    int mant = h & 0x3FF;
+    float f;
+    if (exp == 0)
+        f = ldexpf((float) mant, -24);
+    else if (exp == 31)
+        f = mant ? NAN : INFINITY;
+    else
+        f = ldexpf((float) (mant | 0x400), exp - 25);
+    return (h & 0x8000) ? -f : f;
+}
+
+static int snorm(float v, int max) {
+    v = v < -1.0f ? -1.0f : v > 1.0f ? 1.0f : v;
+    return (int) lroundf(v * (float) max);
+}
+
+/* Picks the packed format of attribute a from its kind and the values it actually holds. */
+static MeshFormat choose_format(const MeshAttrib *attr, const float *vertices, int count,
+                                int floats, int first) {
+    MeshFormat f = {attr->components, GL_FLOAT, GL_FALSE, 0};
+
+    bool fits = true;
+    for (int v = 0; v < count && fits; v++) {
+        const float *c = vertices + v * floats + first;
+        for (int k = 0; k < attr->components && fits; k++) {
+            if (attr->kind == MESH_POSITION)
+                fits = fabsf(half_to_float(float_to_half(c[k])) - c[k]) <= MESH_HALF_TOLERANCE;
+            else if (attr->kind == MESH_COLOR)
+                fits = c[k] >= 0.0f && c[k] <= 1.0f;
+        }
+    }
+
+    switch (attr->kind) {
+        case MESH_POSITION:
+            if (fits && gl_caps.half_float_vertex)
+                f.type = gl_caps.half_float_type;
+            break;
+        case MESH_COLOR:
+            if (fits) {
+                f.type = GL_UNSIGNED_BYTE;
+                f.normalized = GL_TRUE;
+            }
+            break;
+        case MESH_NORMAL:
+            f.normalized = GL_TRUE;
+            if (gl_caps.packed_normals && attr->components == 3) {
+                f.type = GL_INT_2_10_10_10_REV;
+                f.size = 4;   // the packed type is always four components; w is 0
+            } else {
+                f.type = GL_BYTE;
+            }
+            break;
+    }
+    return f;
+}
+
+static int format_bytes(const MeshFormat *f) {
+    int bytes;
+    switch (f->type) {
+        case GL_FLOAT:              bytes = 4 * f->size; break;
+        case GL_UNSIGNED_BYTE:
+        case GL_BYTE:               bytes = f->size; break;
+        case GL_INT_2_10_10_10_REV: bytes = 4; break;
+        default:                    bytes = 2 * f->size; break;   // half float
+    }
+    return (bytes + 3) & ~3;
+}
+
+static void pack(uint8_t *out, const MeshFormat *f, const float *c) {
+    switch (f->type) {
+        case GL_FLOAT:
+            memcpy(out, c, sizeof(float) * f->size);
+            break;
+        case GL_UNSIGNED_BYTE:
+            for (int k = 0; k < f->size; k++)
+                out[k] = (uint8_t) lroundf(c[k] * 255.0f);
+            break;
+        case GL_BYTE:
+            for (int k = 0; k < f->size; k++)
+                out[k] = (uint8_t) (int8_t) snorm(c[k], 127);
+            break;
+        case GL_INT_2_10_10_10_REV: {
+            uint32_t v = (uint32_t) (snorm(c[0], 511) & 0x3FF)
+                         | (uint32_t) (snorm(c[1], 511) & 0x3FF) << 10
+                         | (uint32_t) (snorm(c[2], 511) & 0x3FF) << 20;
+            memcpy(out, &v, 4);
+            break;
+        }
+        default: {   // half float
+            uint16_t h[4];
+            for (int k = 0; k < f->size; k++)
+                h[k] = float_to_half(c[k]);
+            memcpy(out, h, sizeof(uint16_t) * f->size);
+            break;
+        }
+    }
+}
+
+/* ================= MERGING =================
+ * Open-addressed hash over the packed bytes; unique vertices are compacted in first-seen order.
+ * Returns the unique count and fills index[] for every source vertex.
+ */
+
+static uint32_t hash_bytes(const uint8_t *p, int n) {
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < n; i++)
+        h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+static int merge_vertices(uint8_t *packed, int count, int stride, uint16_t *index) {
+    int size = 16;
+    while (size < count * 2)
+        size *= 2;
+    int *table = (int *) malloc(sizeof(int) * size);
+    for (int i = 0; i < size; i++)
+        table[i] = -1;
+
+    int unique = 0;
+    for (int v = 0; v < count; v++) {
+        const uint8_t *vert = packed + v * stride;
+        uint32_t slot = hash_bytes(vert, stride) & (uint32_t) (size - 1);
+        while (table[slot] >= 0 && memcmp(packed + table[slot] * stride, vert, stride) != 0)
+            slot = (slot + 1) & (uint32_t) (size - 1);
+
+        if (table[slot] < 0) {
+            if (unique == 65536)
+                break;   // does not fit 16-bit indices
+            memmove(packed + unique * stride, vert, stride);
+            table[slot] = unique++;
+        }
+        index[v] = (uint16_t) table[slot];
+    }
+    free(table);
+    return unique;
+}
+
+/* ================= UPLOAD ================= */
+
+void mesh_attrib_setup(const Mesh *m) {
+    if (m->ibo)
+        gls_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, m->ibo);
+    gls_bind_buffer(GL_ARRAY_BUFFER, m->vbo);
+
+    unsigned mask = 0;
+    for (int a = 0; a < m->attrib_count; a++) {
+        const MeshFormat *f = &m->attrib[a];
+        gls_attrib_pointer(a, f->size, f->type, f->normalized, m->stride, f->offset);
+        mask |= 1u << a;
+    }
+    gls_attribs(mask);
+}
+
+bool mesh_upload(Mesh *m, GLenum mode, const float *vertices, int vertex_count,
+                 const MeshAttrib *layout, int attrib_count) {
+    memset(m, 0, sizeof(*m));
+    if (vertex_count <= 0 || attrib_count < 1 || attrib_count > MESH_MAX_ATTRIBS)
+        return false;
+    m->mode = mode;
+    m->attrib_count = attrib_count;
+
+    int floats = 0;
+    for (int a = 0; a < attrib_count; a++)
+        floats += layout[a].components;
+
+    for (int k = 0; k < 3; k++) {
+        m->bounds_lo[k] = INFINITY;
+        m->bounds_hi[k] = -INFINITY;
+    }
+    for (int v = 0; v < vertex_count; v++)
+        for (int k = 0; k < 3; k++) {
+            float c = k < layout[0].components ? vertices[v * floats + k] : 0.0f;
+            m->bounds_lo[k] = fminf(m->bounds_lo[k], c);
+            m->bounds_hi[k] = fmaxf(m->bounds_hi[k], c);
+        }
+
+    int stride = 0, first = 0;
+    for (int a = 0; a < attrib_count; a++) {
+        m->attrib[a] = choose_format(&layout[a], vertices, vertex_count, floats, first);
+        m->attrib[a].offset = stride;
+        stride += format_bytes(&m->attrib[a]);
+        first += layout[a].components;
+    }
+    m->stride = stride;
+
+    uint8_t *packed = (uint8_t *) calloc((size_t) vertex_count, (size_t) stride);
+    for (int v = 0; v < vertex_count; v++) {
+        const float *src = vertices + v * floats;
+        for (int a = 0; a < attrib_count; a++) {
+            pack(packed + v * stride + m->attrib[a].offset, &m->attrib[a], src);
+            src += layout[a].components;
+        }
+    }
+
+    /* merge only if the index buffer pays for itself */
+    uint16_t *index = (uint16_t *) malloc(sizeof(uint16_t) * (size_t) vertex_count);
+    uint8_t *merged = (uint8_t *) malloc((size_t) vertex_count * stride);
+    memcpy(merged, packed, (size_t) vertex_count * stride);
+    int unique = merge_vertices(merged, vertex_count, stride, index);
+    bool indexed = unique < 65536 &&
+                   unique * stride + vertex_count * (int) sizeof(uint16_t) < vertex_count * stride;
+
+    m->ibo = 0;
+    glGenBuffers(1, &m->vbo);
+    gls_bind_buffer(GL_ARRAY_BUFFER, m->vbo);
+    if (indexed) {
+        m->vertex_count = unique;
+        m->element_count = vertex_count;
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) stride * unique, merged, GL_STATIC_DRAW);
+
+        glGenBuffers(1, &m->ibo);
+        if (gl_caps.vertex_arrays)
+            gls_bind_vertex_array(0);   // keep the element binding out of whatever VAO is bound
+        gls_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, m->ibo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr) sizeof(uint16_t) * vertex_count, index,
+                     GL_STATIC_DRAW);
+    } else {
+        m->vertex_count = m->element_count = vertex_count;
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) stride * vertex_count, packed, GL_STATIC_DRAW);
+    }
+
+    mesh_stats.meshes++;
+    mesh_stats.vertices += m->vertex_count;
+    mesh_stats.source_vertices += vertex_count;
+    mesh_stats.vertex_bytes += (uint64_t) stride * m->vertex_count;
+    mesh_stats.index_bytes += indexed ? sizeof(uint16_t) * vertex_count : 0;
+    mesh_stats.source_bytes += sizeof(float) * floats * vertex_count;
+
+    free(packed);
+    free(merged);
+    free(index);
+
+    m->vao = 0;
+    if (gl_caps.vertex_arrays) {
+        gl_caps.gen_vertex_arrays(1, &m->vao);
+        gls_bind_vertex_array(m->vao);
+        mesh_attrib_setup(m);
+        gls_bind_vertex_array(0);
+    }
+    return true;
+}
+
+void mesh_dynamic(Mesh *m, GLenum mode, const MeshFormat *attrib, int attrib_count,
+                  GLsizei stride) {
+    memset(m, 0, sizeof(*m));
+    m->mode = mode;
+    m->stride = stride;
+    m->attrib_count = attrib_count;
+    memcpy(m->attrib, attrib, sizeof(MeshFormat) * attrib_count);
+    glGenBuffers(1, &m->vbo);
+
+    if (gl_caps.vertex_arrays) {
+        gl_caps.gen_vertex_arrays(1, &m->vao);
+        gls_bind_vertex_array(m->vao);
+        mesh_attrib_setup(m);
+        gls_bind_vertex_array(0);
+    }
+}
+
+void mesh_stream(Mesh *m, const void *vertices, int vertex_count) {
+    m->vertex_count = m->element_count = vertex_count;
+    gls_bind_buffer(GL_ARRAY_BUFFER, m->vbo);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) m->stride * vertex_count, vertices, GL_STREAM_DRAW);
+}
+
+void mesh_bind(const Mesh *m) {
+    if (m->vao)
+        gls_bind_vertex_array(m->vao);
+    else
+        mesh_attrib_setup(m);
+}
+
+void mesh_draw_range(const Mesh *m, GLint first, GLsizei count, GLsizei instances) {
+    if (m->ibo) {
+        const void *offset = (const void *) (sizeof(uint16_t) * first);
+        if (instances > 0)
+            glDrawElementsInstanced(m->mode, count, GL_UNSIGNED_SHORT, offset, instances);
+        else
+            glDrawElements(m->mode, count, GL_UNSIGNED_SHORT, offset);
+    } else if (instances > 0) {
+        glDrawArraysInstanced(m->mode, first, count, instances);
+    } else {
+        glDrawArrays(m->mode, first, count);
+    }
+}
+
+void mesh_draw(const Mesh *m) {
+    mesh_bind(m);
+    mesh_draw_range(m, 0, m->element_count, 0);
+}
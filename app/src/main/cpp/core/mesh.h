@@ -0,0 +1,103 @@
+#ifndef U3D_CORE_MESH_H
+#define U3D_CORE_MESH_H
+
+#include "gles.h"
+
+#include <stdint.h>
+
+/* ================= MESH =================
+ * A static vertex buffer, an optional index buffer, and the attribute layout they are drawn
+ * with. The layout is recorded once at upload into a VAO when the context has them
+ * (gl_caps.vertex_arrays), so binding a mesh is a single call; otherwise mesh_bind re-specifies
+ * the attributes through gl_state, which still elides repeats.
+ *
+ * Meshes are described as tightly packed floats, attribute i at location i, and packed at
+ * upload according to what each attribute holds:
+ *   MESH_POSITION  half floats (ES3 or OES_vertex_half_float) when every value survives the
+ *                  round trip within MESH_HALF_TOLERANCE, else floats
+ *   MESH_COLOR     normalized unsigned bytes when every value is in [0, 1], else floats
+ *   MESH_NORMAL    normalized 2:10:10:10 (ES3) or signed bytes (ES2)
+ *   MESH_FLOAT     floats
+ * Every attribute starts on a 4-byte boundary. Identical vertices are then merged behind a
+ * 16-bit index buffer whenever that makes the mesh smaller.
+ */
+
+#define MESH_MAX_ATTRIBS    4
+#define MESH_HALF_TOLERANCE 1e-3f   // largest position error accepted for half floats
+
+enum MeshAttribKind {
+    MESH_FLOAT,
+    MESH_POSITION,
+    MESH_COLOR,
+    MESH_NORMAL
+};
+
+/* One source attribute: float component count and what the values are. */
+typedef struct {
+    int components;
+    int kind;       // MeshAttribKind
+} MeshAttrib;
+
+/* How an attribute ended up in the vertex buffer. */
+typedef struct {
+    GLint     size;
+    GLenum    type;
+    GLboolean normalized;
+    GLsizei   offset;   // bytes into the vertex
+} MeshFormat;
+
+typedef struct {
+    GLuint  vbo;
+    GLuint  ibo;                           // 0 if not indexed
+    GLuint  vao;                           // 0 without VAO support
+    GLenum  mode;                          // GL_TRIANGLES, GL_LINES, ...
+    GLsizei vertex_count;                  // vertices in vbo
+    GLsizei element_count;                 // what a full draw covers: indices, or vertices
+    GLsizei stride;                        // bytes
+    int     attrib_count;
+    MeshFormat attrib[MESH_MAX_ATTRIBS];
+    float   bounds_lo[3];                  // box around attribute 0 (missing components 0),
+    float   bounds_hi[3];                  // in model space
+} Mesh;
+
+/* Totals over every upload, for reporting. */
+typedef struct {
+    int      meshes;
+    int      vertices;        // after merging
+    int      source_vertices;
+    uint64_t vertex_bytes;
+    uint64_t index_bytes;
+    uint64_t source_bytes;    // the same meshes as unindexed floats
+} MeshStats;
+
+extern MeshStats mesh_stats;
+
+/* Packs, merges and uploads vertex_count source vertices and builds the VAO. layout has
+ * attrib_count entries. False, with m left empty and nothing uploaded, unless vertex_count is
+ * positive and attrib_count is 1 to MESH_MAX_ATTRIBS. */
+bool mesh_upload(Mesh *m, GLenum mode, const float *vertices, int vertex_count,
+                 const MeshAttrib *layout, int attrib_count);
+
+/* Sets m up for vertices the caller packs itself and re-uploads with mesh_stream (e.g. once per
+ * frame): an unindexed buffer in the given formats, with its VAO. Not counted in mesh_stats. */
+void mesh_dynamic(Mesh *m, GLenum mode, const MeshFormat *attrib, int attrib_count, GLsizei stride);
+
+/* Replaces a dynamic mesh's contents with vertex_count vertices of m->stride bytes. The old
+ * storage is orphaned, so draws still reading it do not stall the upload. */
+void mesh_stream(Mesh *m, const void *vertices, int vertex_count);
+
+/* Makes m the source for subsequent draws. */
+void mesh_bind(const Mesh *m);
+
+/* Draws count elements (indices if the mesh is indexed, else vertices) starting at first, from
+ * the bound mesh; instances > 0 draws instanced. */
+void mesh_draw_range(const Mesh *m, GLint first, GLsizei count, GLsizei instances);
+
+/* Binds and draws every element. */
+void mesh_draw(const Mesh *m);
+
+/* Binds the mesh's own buffers, attribute pointers and enables into whatever VAO is currently
+ * bound (for composite VAOs like the instanced character one). Leaves m->vbo bound. */
+void mesh_attrib_setup(const Mesh *m);
+
+#endif //U3D_CORE_MESH_H
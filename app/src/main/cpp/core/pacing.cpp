@@ -0,0 +1,107 @@
+#include "pacing.h"
+#include "agents.h"
+#include "config.h"
+#include "engine.h"
+#include "snapshot.h"
+
+#include <errno.h>
+#include <time.h>
+
+FramePacing frame_pacing = {-1, 0, 0, 0, true, false};
+
+/* ================= CLOCKS ================= */
+
+static int64_t monotonic_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int64_t monotonic_wait(FrameClock *clock) {
+    int64_t now = monotonic_ns();
+
+    /* Missed deadlines are skipped, not caught up: the next frame starts on the next period. */
+    if (clock->next_ns <= now)
+        clock->next_ns = now + clock->period_ns - (now - clock->next_ns) % clock->period_ns;
+
+    struct timespec ts;
+    ts.tv_sec  = (time_t) (clock->next_ns / 1000000000LL);
+    ts.tv_nsec = (long) (clock->next_ns % 1000000000LL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {}
+
+    int64_t t = clock->next_ns;
+    clock->next_ns += clock->period_ns;
+    return t;
+}
+
+static int64_t synthetic_wait(FrameClock *clock) {
+    int64_t t = clock->next_ns;
+    clock->next_ns += clock->period_ns;
+    return t;
+}
+
+void frame_clock_monotonic(FrameClock *clock, int64_t period_ns) {
+    clock->wait = monotonic_wait;
+    clock->period_ns = period_ns;
+    clock->next_ns = monotonic_ns() + period_ns;
+}
+
+void frame_clock_synthetic(FrameClock *clock, int64_t period_ns) {
+    clock->wait = synthetic_wait;
+    clock->period_ns = period_ns;
+    clock->next_ns = 0;
+}
+
+/* ================= FIXED STEP ================= */
+
+void frame_pacing_reset() {
+    frame_pacing.last_ns = -1;
+    frame_pacing.accumulator_ns = 0;
+}
+
+int frame_tick(int64_t frame_ns) {
+    FramePacing *fp = &frame_pacing;
+
+    /* first frame (or after a reset) only establishes the timeline */
+    if (fp->last_ns < 0 || frame_ns < fp->last_ns)
+        fp->last_ns = frame_ns;
+
+    fp->accumulator_ns += frame_ns - fp->last_ns;
+    fp->last_ns = frame_ns;
+
+    /* a long stall would otherwise try to replay it all at once */
+    if (fp->accumulator_ns > SIM_MAX_STEPS * SIM_STEP_NS) {
+        fp->dropped_ns += fp->accumulator_ns - SIM_MAX_STEPS * SIM_STEP_NS;
+        fp->accumulator_ns = SIM_MAX_STEPS * SIM_STEP_NS;
+    }
+
+    bool dirty = fp->dirty;
+    fp->dirty = false;
+
+    int steps = 0;
+    bool moved = false;
+    while (fp->accumulator_ns >= SIM_STEP_NS) {
+        moved |= sim_step();
+        fp->accumulator_ns -= SIM_STEP_NS;
+        steps++;
+    }
+
+    /* without a step the last one's motion is still being interpolated */
+    if (steps > 0)
+        fp->moving = moved;
+
+    fp->steps = steps;
+
+    /* the poses now belong to the last step's time, accumulator_ns behind the frame */
+    if (steps > 0 || dirty)
+        snapshot_publish(frame_ns - fp->accumulator_ns, fp->moving);
+    return steps;
+}
+
+void frame_invalidate() {
+    frame_pacing.dirty = true;
+}
+
+bool frame_needed() {
+    return frame_pacing.dirty || frame_pacing.moving || engine.joyL_active;
+}
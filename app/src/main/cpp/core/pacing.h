@@ -0,0 +1,57 @@
+#ifndef U3D_CORE_PACING_H
+#define U3D_CORE_PACING_H
+
+#include <stdint.h>
+
+/* ================= FRAME PACING =================
+ * The simulation is driven by a FrameClock that blocks until the next tick should start and
+ * returns its timestamp. It runs at a fixed SIM_HZ regardless of the tick rate: frame_tick runs
+ * however many fixed steps the elapsed time covers and publishes a scene snapshot stamped with
+ * the time of the last step, which the renderer interpolates from (snapshot_alpha).
+ *
+ * frame_tick runs on whichever thread owns the simulation: the sim thread on Android (ticked
+ * at SIM_HZ, see sim_thread.h), or the bench's main loop once per frame.
+ *
+ * The sim only needs ticking while frame_needed(): something was invalidated (input), the last
+ * sim step moved something, or a held control keeps moving things. Otherwise its owner blocks
+ * on input and calls frame_pacing_reset, so the idle time is not simulated on wake-up.
+ */
+
+typedef struct FrameClock {
+    /* Blocks until the next frame is due; returns its time in ns on a monotonic timeline. */
+    int64_t (*wait)(struct FrameClock *clock);
+    int64_t period_ns;   // built-in clocks: frame period
+    int64_t next_ns;     // built-in clocks: deadline of the next frame
+} FrameClock;
+
+/* Sleeps to absolute CLOCK_MONOTONIC deadlines one period apart. */
+void frame_clock_monotonic(FrameClock *clock, int64_t period_ns);
+
+/* Advances by exactly one period per wait without sleeping (benchmarks, tests). */
+void frame_clock_synthetic(FrameClock *clock, int64_t period_ns);
+
+typedef struct {
+    int64_t last_ns;          // timestamp of the previous frame_tick
+    int64_t accumulator_ns;   // elapsed time not yet simulated
+    int     steps;            // fixed steps run by the last frame_tick
+    int64_t dropped_ns;       // time discarded by the SIM_MAX_STEPS clamp
+    bool    dirty;            // a redraw was requested since the last frame_tick
+    bool    moving;           // the last sim step moved something
+} FramePacing;
+
+extern FramePacing frame_pacing;
+
+/* Forgets the previous frame time (after a pause, a surface change, ...). */
+void frame_pacing_reset();
+
+/* Runs the fixed sim steps due at frame_ns and, if anything ran or a redraw was requested,
+ * publishes a scene snapshot. Consumes the redraw request. Returns the number of steps. */
+int frame_tick(int64_t frame_ns);
+
+/* Requests at least one more frame (input, state changes made outside the sim). */
+void frame_invalidate();
+
+/* Whether the next frame would differ from the last one drawn. */
+bool frame_needed();
+
+#endif //U3D_CORE_PACING_H
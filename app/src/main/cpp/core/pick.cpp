@@ -0,0 +1,340 @@
+#include "pick.h"
+#include "camera.h"
+#include "character.h"
+#include "geometry.h"
+#include "mat4.h"
+#include "spatial.h"
+
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+
+#define BVH_LEAF_SIZE   4
+#define BVH_STACK       64
+#define BVH_LOOSE_LIMIT 2.0f   // rebuild once refits have doubled the root's surface area
+
+/* ================= RAYS ================= */
+
+void pick_ray_from_ndc(float nx, float ny, float origin[3], float dir[3]) {
+    const float *m = frame_constants.inv_view_proj;
+    float p[2][3];
+
+    for (int i = 0; i < 2; i++) {
+        float nz = i == 0 ? -1.0f : 1.0f;
+        float w = m[3] * nx + m[7] * ny + m[11] * nz + m[15];
+        for (int a = 0; a < 3; a++)
+            p[i][a] = (m[a] * nx + m[4 + a] * ny + m[8 + a] * nz + m[12 + a]) / w;
+    }
+
+    float d[3] = {p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2]};
+    float len = sqrtf(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+    for (int a = 0; a < 3; a++) {
+        origin[a] = p[0][a];
+        dir[a] = d[a] / len;
+    }
+}
+
+bool ray_plane(const float origin[3], const float dir[3], const float p[3], const float n[3],
+               float *t) {
+    float denom = n[0] * dir[0] + n[1] * dir[1] + n[2] * dir[2];
+    if (fabsf(denom) < 1e-5f)
+        return false;
+
+    float d = (n[0] * (p[0] - origin[0]) + n[1] * (p[1] - origin[1]) + n[2] * (p[2] - origin[2])) / denom;
+    if (d <= 0.0f)
+        return false;
+
+    *t = d;
+    return true;
+}
+
+/* Slab test against [lo, hi]; inv_dir = 1/dir per axis. Entry distance in *t_near. */
+static bool ray_box(const float o[3], const float inv_dir[3], const float lo[3], const float hi[3],
+                    float t_max, float *t_near) {
+    float t0 = 0.0f, t1 = t_max;
+    for (int a = 0; a < 3; a++) {
+        float ta = (lo[a] - o[a]) * inv_dir[a];
+        float tb = (hi[a] - o[a]) * inv_dir[a];
+        if (ta > tb) { float s = ta; ta = tb; tb = s; }
+        if (ta > t0) t0 = ta;
+        if (tb < t1) t1 = tb;
+        if (t0 > t1)
+            return false;
+    }
+    *t_near = t0;
+    return true;
+}
+
+/* Möller–Trumbore; the ray direction need not be normalized. */
+static bool ray_triangle(const float o[3], const float d[3],
+                         const float *v0, const float *v1, const float *v2, float *t) {
+    float e1[3] = {v1[0] - v0[0], v1[1] - v0[1], v1[2] - v0[2]};
+    float e2[3] = {v2[0] - v0[0], v2[1] - v0[1], v2[2] - v0[2]};
+    float p[3] = {d[1] * e2[2] - d[2] * e2[1], d[2] * e2[0] - d[0] * e2[2], d[0] * e2[1] - d[1] * e2[0]};
+    float det = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+    if (fabsf(det) < 1e-8f)
+        return false;
+
+    float inv = 1.0f / det;
+    float s[3] = {o[0] - v0[0], o[1] - v0[1], o[2] - v0[2]};
+    float u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inv;
+    if (u < 0.0f || u > 1.0f)
+        return false;
+
+    float q[3] = {s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0]};
+    float v = (d[0] * q[0] + d[1] * q[1] + d[2] * q[2]) * inv;
+    if (v < 0.0f || u + v > 1.0f)
+        return false;
+
+    *t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inv;
+    return *t >= 0.0f;
+}
+
+/* ================= BVH ================= */
+
+typedef struct {
+    Entity e;
+    float  lo[3], hi[3];
+} BvhItem;
+
+/* Leaf: count > 0, items [first, first + count). Interior: count == 0, left child is the next
+ * node, right child is nodes[first]. */
+typedef struct {
+    float lo[3], hi[3];
+    int   first, count;
+} BvhNode;
+
+static BvhItem *items;
+static int      item_count, item_capacity;
+static BvhNode *nodes;
+static int      node_count, node_capacity;
+static float    built_area;
+static unsigned built_revision;
+static bool     built;
+
+static float char_radius, char_y_min, char_y_max;
+
+static bool item_bounds(BvhItem *it) {
+    int row;
+    EcsChunk *c = ecs_chunk_of(it->e, &row);
+    if (!c)
+        return false;
+
+    float x = c->field[FIELD_X][row], y = c->field[FIELD_Y][row], z = c->field[FIELD_Z][row];
+    it->lo[0] = x - char_radius; it->hi[0] = x + char_radius;
+    it->lo[1] = y + char_y_min;  it->hi[1] = y + char_y_max;
+    it->lo[2] = z - char_radius; it->hi[2] = z + char_radius;
+    return true;
+}
+
+static float surface_area(const float lo[3], const float hi[3]) {
+    float dx = hi[0] - lo[0], dy = hi[1] - lo[1], dz = hi[2] - lo[2];
+    return dx * dy + dy * dz + dz * dx;
+}
+
+static void node_fit(BvhNode *n, int first, int count) {
+    for (int a = 0; a < 3; a++) {
+        n->lo[a] = FLT_MAX;
+        n->hi[a] = -FLT_MAX;
+    }
+    for (int i = first; i < first + count; i++)
+        for (int a = 0; a < 3; a++) {
+            n->lo[a] = fminf(n->lo[a], items[i].lo[a]);
+            n->hi[a] = fmaxf(n->hi[a], items[i].hi[a]);
+        }
+}
+
+/* Median split on the widest axis of the item centres. */
+static void build(int first, int count) {
+    int ni = node_count++;
+    node_fit(&nodes[ni], first, count);
+
+    if (count <= BVH_LEAF_SIZE) {
+        nodes[ni].first = first;
+        nodes[ni].count = count;
+        return;
+    }
+
+    float clo[3] = {FLT_MAX, FLT_MAX, FLT_MAX}, chi[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (int i = first; i < first + count; i++)
+        for (int a = 0; a < 3; a++) {
+            float c = items[i].lo[a] + items[i].hi[a];
+            clo[a] = fminf(clo[a], c);
+            chi[a] = fmaxf(chi[a], c);
+        }
+    int axis = 0;
+    for (int a = 1; a < 3; a++)
+        if (chi[a] - clo[a] > chi[axis] - clo[axis])
+            axis = a;
+
+    int mid = first + count / 2;
+    std::nth_element(items + first, items + mid, items + first + count,
+                     [axis](const BvhItem &a, const BvhItem &b) {
+                         return a.lo[axis] + a.hi[axis] < b.lo[axis] + b.hi[axis];
+                     });
+
+    build(first, mid - first);
+    nodes[ni].first = node_count;
+    nodes[ni].count = 0;
+    build(mid, first + count - mid);
+}
+
+static void rebuild() {
+    item_count = ecs_count(CHARACTER_COMPONENTS);
+    if (item_count > item_capacity) {
+        item_capacity = item_count * 2;
+        items = (BvhItem *) realloc(items, sizeof(BvhItem) * item_capacity);
+    }
+    if (item_count * 2 > node_capacity) {
+        node_capacity = item_count * 4;
+        nodes = (BvhNode *) realloc(nodes, sizeof(BvhNode) * node_capacity);
+    }
+
+    int n = 0;
+    EcsQuery q = ecs_query(CHARACTER_COMPONENTS);
+    while (EcsChunk *c = ecs_next(&q))
+        for (int i = 0; i < c->count; i++) {
+            items[n].e = c->entity[i];
+            item_bounds(&items[n++]);
+        }
+
+    node_count = 0;
+    if (item_count > 0) {
+        build(0, item_count);
+        built_area = surface_area(nodes[0].lo, nodes[0].hi);
+    }
+}
+
+/* Children come after their parent, so a reverse pass sees both children before the parent. */
+static bool refit() {
+    for (int i = 0; i < item_count; i++)
+        if (!item_bounds(&items[i]))
+            return false;
+
+    for (int i = node_count - 1; i >= 0; i--) {
+        BvhNode *n = &nodes[i];
+        if (n->count > 0) {
+            node_fit(n, n->first, n->count);
+            continue;
+        }
+        const BvhNode *l = &nodes[i + 1], *r = &nodes[n->first];
+        for (int a = 0; a < 3; a++) {
+            n->lo[a] = fminf(l->lo[a], r->lo[a]);
+            n->hi[a] = fmaxf(l->hi[a], r->hi[a]);
+        }
+    }
+    return surface_area(nodes[0].lo, nodes[0].hi) <= built_area * BVH_LOOSE_LIMIT;
+}
+
+/* Every mover reports through spatial_update, so an unchanged spatial revision means no
+ * character moved, spawned or died since the last update. */
+static void bvh_update() {
+    if (built && built_revision == spatial_revision())
+        return;
+
+    if (char_radius == 0.0f)
+        character_bounds(&char_radius, &char_y_min, &char_y_max);
+
+    if (item_count == 0 || item_count != ecs_count(CHARACTER_COMPONENTS) || !refit())
+        rebuild();
+
+    built = true;
+    built_revision = spatial_revision();
+}
+
+/* ================= QUERY ================= */
+
+/* Exact hit against one character: part boxes first, then their triangles, all in part-local
+ * space. The local direction is not renormalized, so local t equals world t. */
+static bool hit_character(Entity e, const float o[3], const float d[3], float *best_t, int *best_part) {
+    int row;
+    EcsChunk *c = ecs_chunk_of(e, &row);
+    if (!c)
+        return false;
+
+    float parts[BODY_PARTS * 16];
+    character_part_matrices(parts, c->field[FIELD_X][row], c->field[FIELD_Y][row],
+                            c->field[FIELD_Z][row], c->field[FIELD_ROT][row]);
+
+    static const float lo[3] = {-0.5f, -0.5f, -0.5f}, hi[3] = {0.5f, 0.5f, 0.5f};
+    bool hit = false;
+
+    for (int p = 0; p < BODY_PARTS; p++) {
+        float inv[16];
+        if (!mat4_inverse_affine(inv, parts + p * 16))
+            continue;
+
+        float lo_o[3], lo_d[3], inv_d[3];
+        for (int a = 0; a < 3; a++) {
+            lo_o[a] = inv[a] * o[0] + inv[4 + a] * o[1] + inv[8 + a] * o[2] + inv[12 + a];
+            lo_d[a] = inv[a] * d[0] + inv[4 + a] * d[1] + inv[8 + a] * d[2];
+            inv_d[a] = 1.0f / lo_d[a];
+        }
+
+        float t_box;
+        if (!ray_box(lo_o, inv_d, lo, hi, *best_t, &t_box))
+            continue;
+
+        for (int tri = 0; tri < 12; tri++) {
+            const float *v = cube_vertices + tri * 3 * 9;
+            float t;
+            if (ray_triangle(lo_o, lo_d, v, v + 9, v + 18, &t) && t < *best_t) {
+                *best_t = t;
+                *best_part = p;
+                hit = true;
+            }
+        }
+    }
+    return hit;
+}
+
+Entity pick_ray(const float origin[3], const float dir[3], float *t, int *part) {
+    bvh_update();
+    if (node_count == 0)
+        return ENTITY_NONE;
+
+    float inv_d[3] = {1.0f / dir[0], 1.0f / dir[1], 1.0f / dir[2]};
+    float best_t = FLT_MAX;
+    int best_part = -1;
+    Entity best = ENTITY_NONE;
+
+    int stack[BVH_STACK];
+    int sp = 0;
+    stack[sp++] = 0;
+
+    while (sp > 0) {
+        const BvhNode *n = &nodes[stack[--sp]];
+        float t_near;
+        if (!ray_box(origin, inv_d, n->lo, n->hi, best_t, &t_near))
+            continue;
+
+        if (n->count > 0) {
+            for (int i = n->first; i < n->first + n->count; i++)
+                if (hit_character(items[i].e, origin, dir, &best_t, &best_part))
+                    best = items[i].e;
+            continue;
+        }
+
+        /* push the far child first so the near one is popped next */
+        int l = (int) (n - nodes) + 1, r = n->first;
+        float tl, tr;
+        bool hl = ray_box(origin, inv_d, nodes[l].lo, nodes[l].hi, best_t, &tl);
+        bool hr = ray_box(origin, inv_d, nodes[r].lo, nodes[r].hi, best_t, &tr);
+        if (hl && hr) {
+            if (sp + 2 > BVH_STACK) continue;
+            stack[sp++] = tl < tr ? r : l;
+            stack[sp++] = tl < tr ? l : r;
+        } else if (hl || hr) {
+            if (sp + 1 > BVH_STACK) continue;
+            stack[sp++] = hl ? l : r;
+        }
+    }
+
+    if (best != ENTITY_NONE) {
+        *t = best_t;
+        if (part)
+            *part = best_part;
+    }
+    return best;
+}
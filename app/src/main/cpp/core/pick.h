@@ -0,0 +1,28 @@
+#ifndef U3D_CORE_PICK_H
+#define U3D_CORE_PICK_H
+
+#include "ecs.h"
+
+/* ================= RAY PICKING =================
+ * Touches become world rays through frame_constants.inv_view_proj, so picking follows any
+ * camera pose. Rays are tested against a BVH of character bounds, then against the bounds of
+ * each body part, then against the part's actual cube triangles.
+ *
+ * The BVH is brought up to date lazily by pick_ray: refitted in place when the set of
+ * characters is unchanged, rebuilt when characters were added or removed or the refitted tree
+ * has grown too loose.
+ */
+
+/* World-space ray through an NDC point: origin on the near plane, dir normalized. */
+void pick_ray_from_ndc(float nx, float ny, float origin[3], float dir[3]);
+
+/* Closest character the ray hits, or ENTITY_NONE. On a hit, *t receives the distance along
+ * dir and *part (if not NULL) the BodyPartId that was hit. */
+Entity pick_ray(const float origin[3], const float dir[3], float *t, int *part);
+
+/* Intersects the ray with the plane through p with normal n. Fails for rays parallel to or
+ * pointing away from the plane. */
+bool ray_plane(const float origin[3], const float dir[3], const float p[3], const float n[3],
+               float *t);
+
+#endif //U3D_CORE_PICK_H
@@ -0,0 +1,309 @@
+#include "program.h"
+#include "gl_caps.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+#define CACHE_MAGIC    0x50443355u    // "U3DP"
+#define CACHE_VERSION  1
+#define CACHE_MAX_BLOB (16u << 20)    // anything larger is a corrupt header
+
+ProgramStats program_stats;
+char program_error[PROGRAM_LOG_SIZE];
+
+/* File layout: header, then length bytes of binary. The key is repeated inside so a renamed or
+ * truncated file is never handed to the driver. */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t format;
+    uint32_t length;
+} CacheHeader;
+
+enum BuildState {
+    BUILD_PENDING,
+    BUILD_READY,
+    BUILD_FAILED
+};
+
+typedef struct {
+    GLuint   program;
+    GLuint   vs, fs;          // 0 while loading a binary and once the program is done
+    const char *vs_src, *fs_src;
+    const char *const *attribs;
+    int      attrib_count;
+    uint64_t key;             // 0 = not cached
+    bool     from_binary;     // the pending link is a glProgramBinary load
+    int      state;           // BuildState
+    void   (*on_ready)(GLuint program);
+} Build;
+
+static Build    builds[PROGRAM_MAX];
+static int      build_count;
+static char     cache_dir[512];
+static uint64_t driver_hash;   // 0 = cache off
+
+/* ================= KEYS ================= */
+
+/* FNV-1a over s including its terminator, so consecutive strings cannot run together. */
+static uint64_t fnv1a(uint64_t h, const char *s) {
+    for (;;) {
+        h ^= (uint8_t) *s;
+        h *= 0x100000001B3ull;
+        if (!*s++)
+            return h;
+    }
+}
+
+void program_init(const char *dir) {
+    build_count = 0;
+    memset(&program_stats, 0, sizeof(program_stats));
+    program_error[0] = '\0';
+
+    /* let the driver use as many compiler threads as it likes */
+    if (gl_caps.parallel_compile)
+        gl_caps.max_shader_compiler_threads(0xFFFFFFFFu);
+
+    driver_hash = 0;
+    if (!dir || !gl_caps.program_binary)
+        return;
+    snprintf(cache_dir, sizeof(cache_dir), "%s", dir);
+
+    static const GLenum names[] = {GL_VENDOR, GL_RENDERER, GL_VERSION};
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (GLenum name : names) {
+        const char *s = (const char *) glGetString(name);
+        h = fnv1a(h, s ? s : "");
+    }
+    driver_hash = h ? h : 1;
+}
+
+static uint64_t program_key(const Build *b) {
+    uint64_t h = fnv1a(driver_hash, b->vs_src);
+    h = fnv1a(h, b->fs_src);
+    for (int i = 0; i < b->attrib_count; i++)
+        h = fnv1a(h, b->attribs[i] ? b->attribs[i] : "");
+    return h;
+}
+
+static void cache_path(char *out, size_t size, uint64_t key, const char *suffix) {
+    snprintf(out, size, "%s/program-%016llx%s", cache_dir, (unsigned long long) key, suffix);
+}
+
+/* ================= BINARY CACHE ================= */
+
+/* Starts loading the stored binary for b->key into b->program. False if there is no usable
+ * file; whether the driver accepts the binary is only known once the load completes. */
+static bool cache_load(Build *b) {
+    char path[600];
+    cache_path(path, sizeof(path), b->key, ".bin");
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return false;
+
+    bool loaded = false;
+    CacheHeader h;
+    if (fread(&h, sizeof(h), 1, f) == 1 && h.magic == CACHE_MAGIC &&
+        h.version == CACHE_VERSION && h.key == b->key && h.length > 0 &&
+        h.length <= CACHE_MAX_BLOB) {
+        void *blob = malloc(h.length);
+        if (fread(blob, 1, h.length, f) == h.length) {
+            gl_caps.program_binary_load(b->program, h.format, blob, (GLsizei) h.length);
+            loaded = true;
+        }
+        free(blob);
+    }
+    fclose(f);
+    return loaded;
+}
+
+/* Writes program's binary for key. Goes through a temporary file and a rename, so a crash
+ * mid-write leaves the old file or none, never half of one. */
+static void cache_store(GLuint program, uint64_t key) {
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0 || (uint32_t) length > CACHE_MAX_BLOB)
+        return;
+
+    void *blob = malloc((size_t) length);
+    GLsizei written = 0;
+    GLenum format = 0;
+    gl_caps.get_program_binary(program, length, &written, &format, blob);
+
+    char tmp[600], path[600];
+    cache_path(tmp, sizeof(tmp), key, ".tmp");
+    cache_path(path, sizeof(path), key, ".bin");
+    CacheHeader h = {CACHE_MAGIC, CACHE_VERSION, key, format, (uint32_t) written};
+
+    FILE *f = written > 0 ? fopen(tmp, "wb") : NULL;
+    if (f) {
+        bool ok = fwrite(&h, sizeof(h), 1, f) == 1 &&
+                  fwrite(blob, 1, (size_t) written, f) == (size_t) written;
+        ok = fclose(f) == 0 && ok;
+        if (ok && rename(tmp, path) == 0)
+            program_stats.stored++;
+        else
+            remove(tmp);
+    }
+    free(blob);
+}
+
+/* ================= BUILD ================= */
+
+static GLuint compile(GLenum type, const char *src) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &src, NULL);
+    glCompileShader(shader);
+    return shader;
+}
+
+/* Issues both compiles and the link without asking for any status. A program whose binary was
+ * refused is linked again from source as the same object, so its name stays valid. */
+static void start_source(Build *b) {
+    b->from_binary = false;
+    b->vs = compile(GL_VERTEX_SHADER, b->vs_src);
+    b->fs = compile(GL_FRAGMENT_SHADER, b->fs_src);
+    glAttachShader(b->program, b->vs);
+    glAttachShader(b->program, b->fs);
+    for (int i = 0; i < b->attrib_count; i++)
+        if (b->attribs[i])
+            glBindAttribLocation(b->program, (GLuint) i, b->attribs[i]);
+    if (b->key && gl_caps.es_major >= 3)
+        glProgramParameteri(b->program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(b->program);
+}
+
+/* Copies shader's info log into program_error if it failed to compile. */
+static bool shader_failed(GLuint shader) {
+    GLint ok = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (ok == GL_TRUE)
+        return false;
+    glGetShaderInfoLog(shader, PROGRAM_LOG_SIZE, NULL, program_error);
+    return true;
+}
+
+static void release_shaders(Build *b) {
+    /* deleting attached shaders only flags them; they go with the program */
+    if (b->vs)
+        glDeleteShader(b->vs);
+    if (b->fs)
+        glDeleteShader(b->fs);
+    b->vs = b->fs = 0;
+}
+
+/* Resolves a build whose link has completed (or, without parallel compile, waits for it). */
+static void finish(Build *b) {
+    GLint ok = GL_FALSE;
+    glGetProgramiv(b->program, GL_LINK_STATUS, &ok);
+
+    if (ok != GL_TRUE && b->from_binary) {
+        program_stats.rejected++;
+        start_source(b);
+        return;
+    }
+    program_stats.pending--;
+
+    if (ok != GL_TRUE) {
+        /* only now ask why: a compile log says more than the link log that follows it */
+        if (!shader_failed(b->vs) && !shader_failed(b->fs))
+            glGetProgramInfoLog(b->program, PROGRAM_LOG_SIZE, NULL, program_error);
+        release_shaders(b);
+        glDeleteProgram(b->program);
+        b->state = BUILD_FAILED;
+        program_stats.failed++;
+        return;
+    }
+
+    if (b->from_binary)
+        program_stats.cached++;
+    else if (b->key)
+        cache_store(b->program, b->key);
+    release_shaders(b);
+    b->state = BUILD_READY;
+    if (b->on_ready)
+        b->on_ready(b->program);
+}
+
+static bool complete(const Build *b) {
+    if (!gl_caps.parallel_compile)
+        return true;   // the status query will simply wait
+    GLint done = GL_FALSE;
+    glGetProgramiv(b->program, GL_COMPLETION_STATUS_KHR, &done);
+    return done == GL_TRUE;
+}
+
+/* Newest first: a failed program's name may have been handed out again. */
+static Build *find(GLuint program) {
+    for (int i = build_count - 1; i >= 0; i--)
+        if (builds[i].program == program)
+            return &builds[i];
+    return NULL;
+}
+
+GLuint program_submit(const char *vs, const char *fs, const char *const *attribs,
+                      int attrib_count, void (*on_ready)(GLuint program)) {
+    if (build_count == PROGRAM_MAX) {
+        snprintf(program_error, sizeof(program_error), "more than %d programs", PROGRAM_MAX);
+        program_stats.failed++;
+        return 0;
+    }
+    Build *b = &builds[build_count++];
+    memset(b, 0, sizeof(*b));
+    b->vs_src = vs;
+    b->fs_src = fs;
+    b->attribs = attribs;
+    b->attrib_count = attrib_count;
+    b->on_ready = on_ready;
+    b->state = BUILD_PENDING;
+    b->key = driver_hash ? program_key(b) : 0;
+    b->program = glCreateProgram();
+    program_stats.programs++;
+    program_stats.pending++;
+
+    b->from_binary = b->key && cache_load(b);
+    if (!b->from_binary)
+        start_source(b);
+    return b->program;
+}
+
+void program_poll() {
+    if (program_stats.pending == 0)
+        return;
+    int budget = gl_caps.parallel_compile ? PROGRAM_MAX : 1;
+    for (int i = 0; i < build_count && budget > 0; i++) {
+        Build *b = &builds[i];
+        if (b->state != BUILD_PENDING || !complete(b))
+            continue;
+        finish(b);
+        budget--;
+    }
+}
+
+bool program_ready(GLuint program) {
+    const Build *b = find(program);
+    return b && b->state == BUILD_READY;
+}
+
+bool program_failed(GLuint program) {
+    const Build *b = find(program);
+    return !b || b->state == BUILD_FAILED;
+}
+
+GLuint program_build(const char *vs, const char *fs, const char *const *attribs,
+                     int attrib_count, void (*on_ready)(GLuint program)) {
+    GLuint program = program_submit(vs, fs, attribs, attrib_count, on_ready);
+    Build *b = program ? find(program) : NULL;
+    if (!b)
+        return 0;
+    while (b->state == BUILD_PENDING)
+        finish(b);
+    return b->state == BUILD_READY ? program : 0;
+}
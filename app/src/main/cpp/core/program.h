@@ -0,0 +1,64 @@
+#ifndef U3D_CORE_PROGRAM_H
+#define U3D_CORE_PROGRAM_H
+
+#include "gles.h"
+
+/* ================= PROGRAMS =================
+ * Builds GL programs from source. program_submit issues the compiles and the link and returns
+ * at once; nothing asks the driver for a status until program_poll finds the link complete, so
+ * every program submitted up front compiles while the caller uploads meshes and draws its first
+ * frames. With KHR_parallel_shader_compile (gl_caps.parallel_compile) completion is queried
+ * without blocking and the driver compiles on its own threads. Without it any status query
+ * waits for the link, so program_poll finishes one program per call to spread the stalls over
+ * the first frames. A program's on_ready callback (e.g. fetching uniform locations) runs once
+ * when it has linked; until then program_ready is false and the caller should skip its draws.
+ *
+ * With a cache directory and gl_caps.program_binary, every linked program is also stored as a
+ * glGetProgramBinary blob under a key hashed from its sources, attribute bindings and the
+ * driver's vendor/renderer/version strings, and later launches load that blob instead of
+ * compiling. A blob the driver rejects (or a missing, short or stale file) falls back to source
+ * and is rewritten, so a driver update costs one slow start and nothing else.
+ */
+
+#define PROGRAM_MAX      32
+#define PROGRAM_LOG_SIZE 1024
+
+typedef struct {
+    int programs;   // submitted
+    int pending;    // not yet linked or failed
+    int cached;     // loaded from a stored binary
+    int rejected;   // stored binaries the driver refused (rebuilt from source)
+    int stored;     // binaries written
+    int failed;     // programs that did not compile or link
+} ProgramStats;
+
+extern ProgramStats program_stats;
+
+/* Info log of the most recent compile or link failure, "" if none. */
+extern char program_error[PROGRAM_LOG_SIZE];
+
+/* Forgets every program (call once per new context, after gl_caps_init) and enables the binary
+ * cache in cache_dir (e.g. the app's files dir), which must exist; NULL turns it off. */
+void program_init(const char *cache_dir);
+
+/* Starts building a program from vs and fs, binding attribs[i] to location i (NULL entries are
+ * skipped). The sources and attribs must stay valid until the program is ready (string
+ * literals). Returns the program name, or 0 if PROGRAM_MAX programs exist. */
+GLuint program_submit(const char *vs, const char *fs, const char *const *attribs,
+                      int attrib_count, void (*on_ready)(GLuint program));
+
+/* Finishes whatever submitted programs have completed; call once per frame. */
+void program_poll();
+
+/* Whether program has linked and its on_ready has run. */
+bool program_ready(GLuint program);
+
+/* Whether program failed to build (program_error says why) or is not a submitted program. */
+bool program_failed(GLuint program);
+
+/* program_submit, then waits for the result. Returns 0 and fills program_error if either
+ * shader fails to compile or the program fails to link. */
+GLuint program_build(const char *vs, const char *fs, const char *const *attribs,
+                     int attrib_count, void (*on_ready)(GLuint program));
+
+#endif //U3D_CORE_PROGRAM_H
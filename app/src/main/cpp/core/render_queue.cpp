@@ -0,0 +1,337 @@
+#include "render_queue.h"
+#include "gl_state.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+RqStats rq_stats;
+
+/* ================= FRAME STORAGE ================= */
+
+typedef struct {
+    GLuint  program;
+    RqUniform u;
+} FrameUniform;
+
+typedef struct {
+    uint64_t key;
+    uint32_t index;
+} SortItem;
+
+#define RQ_MAX_FRAME_UNIFORMS 16
+#define RQ_UNIFORM_CACHE      32
+
+static RqPacket *packets;
+static int       packet_count, packet_capacity;
+
+static float    *arena;
+static uint32_t  arena_used, arena_capacity;
+
+static SortItem *sort_a, *sort_b;
+static int       sort_capacity;
+
+static FrameUniform frame_uniforms[RQ_MAX_FRAME_UNIFORMS];
+static int          frame_uniform_count;
+
+/* Last value uploaded to each (program, location) this frame. */
+typedef struct {
+    GLuint program;
+    GLint  location;
+    bool   valid;
+    float  value[16];
+} CachedUniform;
+
+static CachedUniform uniform_cache[RQ_UNIFORM_CACHE];
+static int uniform_cache_count;
+
+static int kind_floats(int kind) {
+    return kind == RQ_MAT4 ? 16 : kind == RQ_VEC2 ? 2 : 1;
+}
+
+static uint32_t arena_alloc(int n) {
+    if (arena_used + n > arena_capacity) {
+        arena_capacity = (arena_used + n) * 2;
+        arena = (float *) realloc(arena, sizeof(float) * arena_capacity);
+    }
+    uint32_t offset = arena_used;
+    arena_used += n;
+    return offset;
+}
+
+static uint32_t arena_copy(const float *v, int n) {
+    uint32_t offset = arena_alloc(n);
+    memcpy(arena + offset, v, sizeof(float) * n);
+    return offset;
+}
+
+/* ================= KEYS ================= */
+
+uint64_t rq_key(int layer, GLuint program, unsigned material, const Mesh *mesh, float depth) {
+    /* overlays stack in the order they were pushed */
+    if (layer == RQ_LAYER_UI)
+        return (uint64_t) RQ_LAYER_UI << 60;
+
+    if (depth < 0.0f) depth = 0.0f;
+    if (depth > 1.0f) depth = 1.0f;
+    GLuint buffer = mesh->vao ? mesh->vao : mesh->vbo;
+
+    return (uint64_t) (layer & 0xF) << 60 |
+           (uint64_t) (program & 0xFF) << 52 |
+           (uint64_t) (material & 0xFFF) << 40 |
+           (uint64_t) (buffer & 0xFFFF) << 24 |
+           (uint64_t) (depth * 0xFFFFFF);
+}
+
+/* ================= QUEUE ================= */
+
+void rq_begin() {
+    packet_count = 0;
+    arena_used = 0;
+    frame_uniform_count = 0;
+    uniform_cache_count = 0;
+}
+
+void rq_frame_uniform(GLuint program, GLint location, int kind, const float *v) {
+    if (frame_uniform_count == RQ_MAX_FRAME_UNIFORMS)
+        return;
+    FrameUniform *f = &frame_uniforms[frame_uniform_count++];
+    f->program = program;
+    f->u.location = location;
+    f->u.kind = (uint8_t) kind;
+    f->u.offset = arena_copy(v, kind_floats(kind));
+    f->u.values = NULL;
+}
+
+RqPacket *rq_push(uint64_t key, GLuint program, const Mesh *mesh, GLint first, GLsizei count,
+                  GLsizei instances) {
+    if (packet_count == packet_capacity) {
+        packet_capacity = packet_capacity ? packet_capacity * 2 : 256;
+        packets = (RqPacket *) realloc(packets, sizeof(RqPacket) * packet_capacity);
+    }
+    RqPacket *p = &packets[packet_count++];
+    p->key = key;
+    p->program = program;
+    p->mesh = mesh;
+    p->first = first;
+    p->count = count;
+    p->instances = instances;
+    p->line_width = 1.0f;
+    p->repeat = 1;
+    p->stream = false;
+    p->uniform_count = 0;
+    return p;
+}
+
+RqPacket *rq_push_mesh(uint64_t key, GLuint program, const Mesh *mesh) {
+    return rq_push(key, program, mesh, 0, mesh->element_count, 0);
+}
+
+void rq_uniform(RqPacket *p, GLint location, int kind, const float *v) {
+    if (p->uniform_count == RQ_PACKET_UNIFORMS)
+        return;
+    RqUniform *u = &p->uniform[p->uniform_count++];
+    u->location = location;
+    u->kind = (uint8_t) kind;
+    u->offset = arena_copy(v, kind_floats(kind));
+    u->values = NULL;
+}
+
+/* The per-draw stream always comes first so the other uniforms can be uploaded once. */
+static RqUniform *insert_stream(RqPacket *p, GLint location, int kind, int n) {
+    if (n < 1 || p->stream || p->uniform_count == RQ_PACKET_UNIFORMS)
+        return NULL;
+    memmove(&p->uniform[1], &p->uniform[0], sizeof(RqUniform) * p->uniform_count);
+    p->uniform_count++;
+    p->repeat = n;
+    p->stream = true;
+
+    RqUniform *u = &p->uniform[0];
+    u->location = location;
+    u->kind = (uint8_t) kind;
+    u->offset = 0;
+    u->values = NULL;
+    return u;
+}
+
+float *rq_uniform_stream(RqPacket *p, GLint location, int kind, int n) {
+    RqUniform *u = insert_stream(p, location, kind, n);
+    if (!u)
+        return NULL;
+    u->offset = arena_alloc(kind_floats(kind) * n);
+    return arena + u->offset;
+}
+
+void rq_uniform_stream_from(RqPacket *p, GLint location, int kind, int n, const float *values) {
+    RqUniform *u = insert_stream(p, location, kind, n);
+    if (u)
+        u->values = values;
+}
+
+/* ================= SORT ================= */
+
+/* LSD radix sort on 8-bit digits. Digits that are equal across every key are skipped, which
+ * with this key layout is most of them on small queues. */
+static SortItem *radix_sort(SortItem *a, SortItem *b, int n) {
+    static uint32_t hist[8][256];
+    memset(hist, 0, sizeof(hist));
+    for (int i = 0; i < n; i++)
+        for (int d = 0; d < 8; d++)
+            hist[d][(a[i].key >> (d * 8)) & 0xFF]++;
+
+    for (int d = 0; d < 8; d++) {
+        uint32_t *h = hist[d];
+        if (h[(a[0].key >> (d * 8)) & 0xFF] == (uint32_t) n)
+            continue;
+
+        uint32_t sum = 0;
+        for (int v = 0; v < 256; v++) {
+            uint32_t c = h[v];
+            h[v] = sum;
+            sum += c;
+        }
+        for (int i = 0; i < n; i++)
+            b[h[(a[i].key >> (d * 8)) & 0xFF]++] = a[i];
+
+        SortItem *t = a;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/* ================= SUBMIT ================= */
+
+static void issue(const RqUniform *u, const float *v) {
+    rq_stats.uniform_uploads++;
+    switch (u->kind) {
+        case RQ_FLOAT: glUniform1f(u->location, v[0]); break;
+        case RQ_VEC2:  glUniform2f(u->location, v[0], v[1]); break;
+        case RQ_MAT4:  glUniformMatrix4fv(u->location, 1, GL_FALSE, v); break;
+    }
+}
+
+/* Cache entry for (program, location), allocated on first use; NULL once the cache is full. */
+static CachedUniform *cache_slot(GLuint program, GLint location) {
+    for (int i = 0; i < uniform_cache_count; i++)
+        if (uniform_cache[i].program == program && uniform_cache[i].location == location)
+            return &uniform_cache[i];
+    if (uniform_cache_count == RQ_UNIFORM_CACHE)
+        return NULL;
+    CachedUniform *c = &uniform_cache[uniform_cache_count++];
+    c->program = program;
+    c->location = location;
+    c->valid = false;
+    return c;
+}
+
+/* Uploads u unless the program already holds the same value. */
+static void upload(GLuint program, const RqUniform *u) {
+    const float *v = arena + u->offset;
+    size_t bytes = sizeof(float) * kind_floats(u->kind);
+
+    CachedUniform *c = cache_slot(program, u->location);
+    if (c) {
+        if (c->valid && !memcmp(c->value, v, bytes)) {
+            rq_stats.uniforms_elided++;
+            return;
+        }
+        c->valid = true;
+        memcpy(c->value, v, bytes);
+    }
+    issue(u, v);
+}
+
+/* Per-draw values are all different by construction; upload them without comparing and
+ * forget whatever the cache held for that location. */
+static void upload_stream(GLuint program, const RqPacket *p) {
+    const RqUniform *u = &p->uniform[0];
+    const float *v = u->values ? u->values : arena + u->offset;
+    int floats = kind_floats(u->kind);
+
+    CachedUniform *c = cache_slot(program, u->location);
+    if (c)
+        c->valid = false;
+
+    for (int r = 0; r < p->repeat; r++, v += floats) {
+        issue(u, v);
+        mesh_draw_range(p->mesh, p->first, p->count, p->instances);
+    }
+}
+
+static void apply_layer(int layer) {
+    if (layer == RQ_LAYER_BLEND)
+        gls_enable(GL_BLEND);
+    else
+        gls_disable(GL_BLEND);
+
+    if (layer == RQ_LAYER_UI) {
+        gls_disable(GL_DEPTH_TEST);
+        gls_depth_mask(GL_TRUE);
+        return;
+    }
+    gls_enable(GL_DEPTH_TEST);
+    gls_depth_func(layer == RQ_LAYER_SKY ? GL_LEQUAL : GL_LESS);
+    gls_depth_mask(layer == RQ_LAYER_OPAQUE ? GL_TRUE : GL_FALSE);
+}
+
+void rq_submit() {
+    int n = packet_count;
+    memset(&rq_stats, 0, sizeof(rq_stats));
+    rq_stats.packets = n;
+    if (n == 0)
+        return;
+
+    if (n > sort_capacity) {
+        sort_capacity = n * 2;
+        sort_a = (SortItem *) realloc(sort_a, sizeof(SortItem) * sort_capacity);
+        sort_b = (SortItem *) realloc(sort_b, sizeof(SortItem) * sort_capacity);
+    }
+    for (int i = 0; i < n; i++) {
+        sort_a[i].key = packets[i].key;
+        sort_a[i].index = (uint32_t) i;
+    }
+    const SortItem *order = radix_sort(sort_a, sort_b, n);
+
+    bool frame_applied[RQ_MAX_FRAME_UNIFORMS] = {};
+    int layer = -1;
+    GLuint program = 0;
+    const Mesh *mesh = NULL;
+
+    for (int i = 0; i < n; i++) {
+        const RqPacket *p = &packets[order[i].index];
+
+        int l = (int) (p->key >> 60);
+        if (l != layer) {
+            layer = l;
+            apply_layer(layer);
+        }
+
+        if (p->program != program) {
+            program = p->program;
+            rq_stats.program_binds++;
+            gls_use_program(program);
+            for (int f = 0; f < frame_uniform_count; f++) {
+                if (frame_uniforms[f].program != program || frame_applied[f])
+                    continue;
+                frame_applied[f] = true;
+                upload(program, &frame_uniforms[f].u);
+            }
+        }
+
+        if (p->mesh != mesh) {
+            mesh = p->mesh;
+            rq_stats.mesh_binds++;
+            mesh_bind(mesh);
+        }
+
+        for (int u = p->stream ? 1 : 0; u < p->uniform_count; u++)
+            upload(program, &p->uniform[u]);
+
+        gls_line_width(p->line_width);
+
+        if (p->stream)
+            upload_stream(program, p);
+        else
+            mesh_draw_range(mesh, p->first, p->count, p->instances);
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef U3D_CORE_RENDER_QUEUE_H
+#define U3D_CORE_RENDER_QUEUE_H
+
+#include "gles.h"
+#include "mesh.h"
+
+#include <stdint.h>
+
+/* ================= RENDER QUEUE =================
+ * Passes push draw packets instead of drawing. Each packet carries a 64-bit sort key
+ *
+ *   63..60 layer | 59..52 program | 51..40 material | 39..24 buffer | 23..0 depth
+ *
+ * and rq_submit radix-sorts them and issues everything in one pass, so packets that share a
+ * program, material or mesh end up adjacent and state changes collapse no matter what order the
+ * passes ran in. The layer fixes depth and blend state (see RqLayer); within a layer, depth orders
+ * packets front to back. Sorting is stable, so packets with equal keys keep their push order.
+ *
+ * Uniform values are copied into a per-frame arena at push time, so callers may pass
+ * temporaries. Uniforms that stay fixed for the frame (view_proj) are registered once per
+ * program with rq_frame_uniform and uploaded when the program is first used.
+ */
+
+enum RqLayer {
+    RQ_LAYER_OPAQUE,   // depth test on, depth writes on
+    RQ_LAYER_SKY,      // depth test on (GL_LEQUAL, so the far plane passes), depth writes off
+    RQ_LAYER_BLEND,    // depth test on, depth writes off, alpha blending; pass 1 - depth in keys
+                       // to draw back to front
+    RQ_LAYER_UI,       // depth test off; keys ignore everything else, so push order is kept
+    RQ_LAYER_COUNT
+};
+
+enum RqUniformKind {
+    RQ_FLOAT,
+    RQ_VEC2,
+    RQ_MAT4
+};
+
+#define RQ_PACKET_UNIFORMS 2
+
+typedef struct {
+    GLint    location;
+    uint8_t  kind;       // RqUniformKind
+    uint32_t offset;     // into the frame's uniform arena
+    const float *values; // caller-owned stream values instead (rq_uniform_stream_from), or NULL
+} RqUniform;
+
+typedef struct {
+    uint64_t    key;
+    GLuint      program;
+    const Mesh *mesh;
+    GLint       first;
+    GLsizei     count;
+    GLsizei     instances;     // 0 = not instanced
+    GLfloat     line_width;
+    int         repeat;        // draws issued; see rq_uniform_stream
+    bool        stream;        // uniform[0] holds one value per draw
+    int         uniform_count;
+    RqUniform   uniform[RQ_PACKET_UNIFORMS];
+} RqPacket;
+
+typedef struct {
+    int packets;          // submitted by the last rq_submit
+    int program_binds;
+    int mesh_binds;
+    int uniform_uploads;
+    int uniforms_elided;  // same value already in the program
+} RqStats;
+
+extern RqStats rq_stats;
+
+/* Packs a sort key. depth is a view distance in [0, 1] (clamped). */
+uint64_t rq_key(int layer, GLuint program, unsigned material, const Mesh *mesh, float depth);
+
+/* Empties the queue and the uniform arena for a new frame. */
+void rq_begin();
+
+/* Uploads v to program's location the first time program is used in this frame's submit. */
+void rq_frame_uniform(GLuint program, GLint location, int kind, const float *v);
+
+/* Queues a draw of mesh's elements [first, first + count) (instances > 0 for instanced).
+ * The packet is valid until the next rq_push. */
+RqPacket *rq_push(uint64_t key, GLuint program, const Mesh *mesh, GLint first, GLsizei count,
+                  GLsizei instances);
+
+/* Whole-mesh shorthand for rq_push. */
+RqPacket *rq_push_mesh(uint64_t key, GLuint program, const Mesh *mesh);
+
+/* Attaches a uniform value (copied) to p. */
+void rq_uniform(RqPacket *p, GLint location, int kind, const float *v);
+
+/* Attaches n consecutive values, one per draw: the packet is drawn n times, uploading the next
+ * value before each. Other uniforms on the packet are uploaded once. Lets a group of draws that
+ * differ only in one uniform (a character's body parts) travel as one packet.
+ *
+ * Returns arena space for the n values, which the caller fills in place; it is valid until
+ * the next rq_* call. NULL (leaving the packet as it was) if n < 1, the packet already has
+ * a stream or it already has RQ_PACKET_UNIFORMS uniforms. */
+float *rq_uniform_stream(RqPacket *p, GLint location, int kind, int n);
+
+/* As rq_uniform_stream, but reads the n values from caller memory at submit time instead of
+ * copying them, for values that already sit in a persistent array (e.g. a transform tree).
+ * They must stay unchanged until rq_submit. */
+void rq_uniform_stream_from(RqPacket *p, GLint location, int kind, int n, const float *values);
+
+/* Sorts and issues every queued packet. */
+void rq_submit();
+
+#endif //U3D_CORE_RENDER_QUEUE_H
@@ -0,0 +1,524 @@
+#include "scene.h"
+#include "asset.h"
+#include "camera.h"
+#include "character.h"
+#include "cull.h"
+#include "geometry.h"
+#include "gl_caps.h"
+#include "gl_state.h"
+#include "gles.h"
+#include "jobs.h"
+#include "mat4.h"
+#include "mesh.h"
+#include "program.h"
+#include "render_queue.h"
+#include "shaders.h"
+#include "snapshot.h"
+#include "texture.h"
+#include "transform.h"
+#include "ui.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ================= GL OBJECTS ================= */
+
+static GLuint prog, sky_prog, axis_prog, grid_prog;
+static GLint  uViewProj, uModel, uSelected, sky_uInvViewProj, axis_uViewProj, axis_uModel;
+static GLint  grid_uViewProj, grid_uModel, grid_uGrid, grid_uFade;
+
+static Mesh cube_mesh, sky_mesh, axis_mesh, sel_mesh, ground_mesh;
+
+/* vertex layouts, one entry per attribute location */
+static const MeshAttrib LAYOUT_POS[]       = {{3, MESH_POSITION}};
+static const MeshAttrib LAYOUT_CLIP[]      = {{2, MESH_POSITION}};
+static const MeshAttrib LAYOUT_POS_COL[]   = {{3, MESH_POSITION}, {3, MESH_COLOR}};
+static const MeshAttrib LAYOUT_POS_COL_N[] = {{3, MESH_POSITION}, {3, MESH_COLOR}, {3, MESH_NORMAL}};
+
+/* ES3 instanced character path */
+#define INST_ATTR_MODEL    3   // mat4, locations 3..6
+#define INST_ATTR_SELECTED 7
+
+/* attribute names by location; programs bind a prefix of one of these */
+static const char *const ATTRIBS_POS_COL_N[] = {"aPos", "aColor", "aNormal"};
+static const char *const ATTRIBS_INSTANCED[] = {"aPos", "aColor", "aNormal", "aModel",
+                                                NULL, NULL, NULL, "aSelected"};
+
+#define CHARACTER_GRAIN    256   // characters per job when posing transform roots
+
+static GLuint inst_prog, inst_vbo, inst_sel_vbo, inst_vao;
+static Mesh   inst_mesh;       // cube_mesh drawn through inst_vao
+static GLint  inst_uViewProj;
+static float *instance_models; // visible characters' part matrices, when some are culled
+static float *instance_flags;  // selection flag per instance
+static int    instance_capacity;
+
+static const float identity[16] = {
+        1, 0, 0, 0,
+        0, 1, 0, 0,
+        0, 0, 1, 0,
+        0, 0, 0, 1
+};
+
+/* ================= DRAW ================= */
+
+/* Distance along the view axis as a fraction of CAM_FAR, for front-to-back sort keys. */
+static float view_depth(const FrameConstants *fc, float x, float y, float z) {
+    const float *m = fc->view_proj;
+    return (m[3] * x + m[7] * y + m[11] * z + m[15]) * (1.0f / CAM_FAR);
+}
+
+/* ================= CHARACTER TRANSFORMS =================
+ * One root per character (its interpolated pose) with BODY_PARTS children holding the constant
+ * body_part_local matrices. Roots are rewritten every frame but only dirtied when the pose
+ * actually changed, so characters at rest cost a compare instead of six matrix products. The
+ * parts level is laid out character by character, which is exactly the instance model stream.
+ */
+
+static TransformTree character_xf;
+static int           character_xf_count = -1;   // characters the tree was built for
+
+static void build_character_xf(int count) {
+    transform_clear(&character_xf);
+    for (int i = 0; i < count; i++)
+        transform_add(&character_xf, -1, NULL);
+    for (int i = 0; i < count; i++)
+        for (int p = 0; p < BODY_PARTS; p++)
+            transform_add(&character_xf, i, body_part_local[p]);
+    character_xf_count = count;
+}
+
+/* ================= CHARACTER CULLING =================
+ * Each character is bounded by one sphere around all its parts (character_bounds), centred on
+ * the interpolated root. Spheres are tested against the frustum in SIMD batches across jobs,
+ * then the survivors are compacted in index order into visible[], which both character paths
+ * draw from.
+ */
+
+static float   character_radius, character_center_y;
+static float  *cull_x, *cull_y, *cull_z;
+static uint8_t *cull_flag;
+static int    *visible, *prev_visible;
+static int     visible_count, prev_visible_count;
+static int     cull_capacity;
+
+static void cull_reserve(int count) {
+    if (count <= cull_capacity)
+        return;
+    cull_capacity = count * 2;
+    cull_x = (float *) realloc(cull_x, sizeof(float) * cull_capacity);
+    cull_y = (float *) realloc(cull_y, sizeof(float) * cull_capacity);
+    cull_z = (float *) realloc(cull_z, sizeof(float) * cull_capacity);
+    cull_flag = (uint8_t *) realloc(cull_flag, cull_capacity);
+    visible = (int *) realloc(visible, sizeof(int) * cull_capacity);
+    prev_visible = (int *) realloc(prev_visible, sizeof(int) * cull_capacity);
+}
+
+typedef struct {
+    const SceneSnapshot *s;
+    float alpha;
+    const Frustum *frustum;
+} CharacterPose;
+
+static void pose_roots(void *arg, int begin, int end) {
+    const CharacterPose *c = (const CharacterPose *) arg;
+    for (int i = begin; i < end; i++) {
+        float x, y, z, rot, root[16];
+        snapshot_pose(c->s, i, c->alpha, &x, &y, &z, &rot);
+        mat4_translate_rotate_y(root, x, y, z, rot);
+        transform_set_local(&character_xf, i, root);
+
+        cull_x[i] = x;
+        cull_y[i] = y + character_center_y;
+        cull_z[i] = z;
+    }
+    frustum_test_spheres(c->frustum, cull_x + begin, cull_y + begin, cull_z + begin,
+                         character_radius, end - begin, cull_flag + begin);
+}
+
+/* Poses and culls every character and brings the part world matrices up to date. Returns how
+ * many matrices changed; *visible_changed tells whether visible[] differs from last frame. */
+static int update_characters(const SceneSnapshot *s, float alpha, const Frustum *f,
+                             bool *visible_changed) {
+    if (s->count != character_xf_count)
+        build_character_xf(s->count);
+    cull_reserve(s->count);
+
+    CharacterPose pose = {s, alpha, f};
+    parallel_for(s->count, CHARACTER_GRAIN, pose_roots, &pose);
+
+    int *t = prev_visible;
+    prev_visible = visible;
+    visible = t;
+    prev_visible_count = visible_count;
+
+    visible_count = 0;
+    for (int i = 0; i < s->count; i++)
+        if (cull_flag[i])
+            visible[visible_count++] = i;
+
+    cull_stats.tested += s->count;
+    cull_stats.visible += visible_count;
+    *visible_changed = visible_count != prev_visible_count ||
+                       memcmp(visible, prev_visible, sizeof(int) * visible_count) != 0;
+
+    /* culled characters keep their dirty flags too; the sweep is cheap next to the draw */
+    return transform_update(&character_xf);
+}
+
+const TransformTree *scene_character_transforms() {
+    return &character_xf;
+}
+
+/* World matrices of character i's parts, BODY_PARTS * 16 floats. */
+static const float *character_parts(int i) {
+    return transform_world(&character_xf, character_xf_count + i * BODY_PARTS);
+}
+
+/* ================= CHARACTERS (ES2) =================
+ * One packet per visible character, drawing each body part with its own model matrix. The
+ * selection flag is the material, so the queue groups selected and unselected characters and
+ * uSelected only changes once.
+ */
+
+static void push_characters(const SceneSnapshot *s, float alpha, const FrameConstants *fc,
+                            const Frustum *f) {
+    bool changed;
+    update_characters(s, alpha, f, &changed);
+
+    for (int v = 0; v < visible_count; v++) {
+        int i = visible[v];
+        float sel = i == s->selected ? 1.0f : 0.0f;
+
+        const float *root = transform_world(&character_xf, i);
+        uint64_t key = rq_key(RQ_LAYER_OPAQUE, prog, (unsigned) sel, &cube_mesh,
+                              view_depth(fc, root[12], root[13], root[14]));
+        RqPacket *packet = rq_push_mesh(key, prog, &cube_mesh);
+        rq_uniform(packet, uSelected, RQ_FLOAT, &sel);
+        rq_uniform_stream_from(packet, uModel, RQ_MAT4, BODY_PARTS, character_parts(i));
+    }
+}
+
+/* ================= CHARACTERS (ES3 INSTANCED) =================
+ * Every body part of every visible agent in one instanced packet. Model matrices and selection
+ * flags live in two instance buffers; inst_vao records the cube attributes plus both instance
+ * streams once. With everything visible the model stream is the transform tree's part level
+ * as-is; otherwise the visible characters' parts are gathered first. Either buffer is only
+ * re-uploaded when its contents changed.
+ */
+
+static bool instance_valid;          // the buffers hold the current visible set
+static int  instance_selected = -1;  // selection the flag buffer was filled for
+
+static void gather_instances(void *, int begin, int end) {
+    for (int v = begin; v < end; v++)
+        memcpy(instance_models + v * BODY_PARTS * 16, character_parts(visible[v]),
+               sizeof(float) * 16 * BODY_PARTS);
+}
+
+static void push_characters_instanced(const SceneSnapshot *s, float alpha, const Frustum *f) {
+    bool changed;
+    int moved = update_characters(s, alpha, f, &changed);
+    if (changed)
+        instance_valid = false;
+
+    int count = visible_count * BODY_PARTS;
+    if (count == 0)
+        return;
+    if (count > instance_capacity) {
+        instance_capacity = count * 2;
+        instance_models = (float *) realloc(instance_models, sizeof(float) * 16 * instance_capacity);
+        instance_flags = (float *) realloc(instance_flags, sizeof(float) * instance_capacity);
+    }
+
+    if (moved > 0 || !instance_valid) {
+        const float *models = character_parts(0);
+        if (visible_count < s->count) {
+            parallel_for(visible_count, CHARACTER_GRAIN, gather_instances, NULL);
+            models = instance_models;
+        }
+        gls_bind_buffer(GL_ARRAY_BUFFER, inst_vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * count * 16, models, GL_STREAM_DRAW);
+    }
+    if (s->selected != instance_selected || !instance_valid) {
+        for (int v = 0; v < visible_count; v++) {
+            float sel = visible[v] == s->selected ? 1.0f : 0.0f;
+            for (int p = 0; p < BODY_PARTS; p++)
+                instance_flags[v * BODY_PARTS + p] = sel;
+        }
+        gls_bind_buffer(GL_ARRAY_BUFFER, inst_sel_vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * count, instance_flags, GL_STREAM_DRAW);
+        instance_selected = s->selected;
+    }
+    instance_valid = true;
+
+    rq_push(rq_key(RQ_LAYER_OPAQUE, inst_prog, 0, &inst_mesh, 0.0f), inst_prog, &inst_mesh,
+            0, inst_mesh.element_count, count);
+}
+
+/* Cube attributes plus the two instance streams. Instancing implies ES3, which has VAOs. */
+static void build_instance_vao() {
+    gl_caps.gen_vertex_arrays(1, &inst_vao);
+    gls_bind_vertex_array(inst_vao);
+
+    mesh_attrib_setup(&cube_mesh);
+
+    gls_bind_buffer(GL_ARRAY_BUFFER, inst_vbo);
+    for (int c = 0; c < 4; c++) {
+        gls_attrib_pointer(INST_ATTR_MODEL + c, 4, GL_FLOAT, GL_FALSE, 16 * sizeof(float),
+                           c * 4 * sizeof(float));
+        gls_attrib_divisor(INST_ATTR_MODEL + c, 1);
+    }
+    gls_bind_buffer(GL_ARRAY_BUFFER, inst_sel_vbo);
+    gls_attrib_pointer(INST_ATTR_SELECTED, 1, GL_FLOAT, GL_FALSE, 0, 0);
+    gls_attrib_divisor(INST_ATTR_SELECTED, 1);
+    gls_attribs(0x7 | (0xF << INST_ATTR_MODEL) | (1 << INST_ATTR_SELECTED));
+
+    gls_bind_vertex_array(0);
+
+    inst_mesh = cube_mesh;
+    inst_mesh.vao = inst_vao;
+}
+
+/* ================= PROGRAMS =================
+ * The sky and HUD programs are small and built before the first frame. The world programs
+ * compile in the background (see program.h); until each is ready its draws are skipped, so
+ * the first frames show the sky and HUD and the rest appears as it links.
+ */
+
+static void locate_world(GLuint p) {
+    uViewProj = glGetUniformLocation(p, "uViewProj");
+    uModel = glGetUniformLocation(p, "uModel");
+    uSelected = glGetUniformLocation(p, "uSelected");
+}
+
+static void locate_instanced(GLuint p) {
+    inst_uViewProj = glGetUniformLocation(p, "uViewProj");
+}
+
+static void locate_axis(GLuint p) {
+    axis_uViewProj = glGetUniformLocation(p, "uViewProj");
+    axis_uModel = glGetUniformLocation(p, "uModel");
+}
+
+static void locate_grid(GLuint p) {
+    grid_uViewProj = glGetUniformLocation(p, "uViewProj");
+    grid_uModel = glGetUniformLocation(p, "uModel");
+    grid_uGrid = glGetUniformLocation(p, "uGrid");
+    grid_uFade = glGetUniformLocation(p, "uFade");
+}
+
+static void locate_sky(GLuint p) {
+    sky_uInvViewProj = glGetUniformLocation(p, "uInvViewProj");
+}
+
+/* ================= INIT ================= */
+
+void scene_init(const char *cache_dir) {
+    gl_caps_init();
+    gls_reset();
+    program_init(cache_dir);
+    texture_init();
+
+    /* submitted first so the driver compiles them while everything else is set up */
+    prog = program_submit(vs_src, fs_src, ATTRIBS_POS_COL_N, 3, locate_world);
+    if (gl_caps.instancing)
+        inst_prog = program_submit(inst_vs, inst_fs, ATTRIBS_INSTANCED, INST_ATTR_SELECTED + 1,
+                                   locate_instanced);
+    axis_prog = program_submit(axis_vs, axis_fs, ATTRIBS_POS_COL_N, 2, locate_axis);
+    grid_prog = program_submit(grid_vs, grid_fs, ATTRIBS_POS_COL_N, 1, locate_grid);
+
+    instance_valid = false;
+    instance_selected = -1;
+
+    float radius, y_min, y_max;
+    character_bounds(&radius, &y_min, &y_max);
+    float half_height = (y_max - y_min) * 0.5f;
+    character_center_y = (y_min + y_max) * 0.5f;
+    character_radius = sqrtf(radius * radius + half_height * half_height);
+
+    gls_enable(GL_DEPTH_TEST);
+
+    if (gl_caps.instancing) {
+        glGenBuffers(1, &inst_vbo);
+        glGenBuffers(1, &inst_sel_vbo);
+    }
+
+    /* cube geometry */
+    mesh_upload(&cube_mesh, GL_TRIANGLES, cube_vertices, 36, LAYOUT_POS_COL_N, 3);
+    if (gl_caps.instancing)
+        build_instance_vao();
+
+    /* ================= SKYBOX GEOMETRY ================= */
+
+    mesh_upload(&sky_mesh, GL_TRIANGLES, sky_triangle_vertices, 3, LAYOUT_CLIP, 1);
+
+    sky_prog = program_build(sky_vs, sky_fs, ATTRIBS_POS_COL_N, 1, locate_sky);
+
+    /* axis */
+    mesh_upload(&axis_mesh, GL_LINES, axis_vertices, 6, LAYOUT_POS_COL, 2);
+
+    /* ================= SELECTION RING ================= */
+
+    float sel_ring[SEL_SEGMENTS * 6 * 2];
+    build_sel_ring(sel_ring);
+
+    mesh_upload(&sel_mesh, GL_LINES, sel_ring, SEL_SEGMENTS * 2, LAYOUT_POS_COL, 2);
+
+    /* ================= GRID FLOOR ================= */
+
+    mesh_upload(&ground_mesh, GL_TRIANGLES, ground_quad_vertices, 6, LAYOUT_POS, 1);
+
+    /* only the grid blends; it is drawn over the opaque geometry without writing depth */
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    /* ================= HUD ================= */
+
+    ui_init();
+}
+
+/* ================= FRAME ================= */
+
+static const float  axis_btn_color[3][3] = {
+        {1.0f, 0.3f, 0.3f},   // X = red
+        {0.3f, 1.0f, 0.3f},   // Y = green
+        {0.3f, 0.6f, 1.0f},   // Z = blue
+};
+static const float *axis_glyph[3] = {glyph_X, glyph_Y, glyph_Z};
+static const int    axis_glyph_count[3] = {4, 6, 6};
+
+/* Frustum test for a world-space box, counted in cull_stats. */
+static bool visible_box(const Frustum *f, const float *lo, const float *hi) {
+    bool in = frustum_test_aabb(f, lo, hi);
+    cull_stats.tested++;
+    cull_stats.visible += in;
+    return in;
+}
+
+/* Sphere test standing in for `objects` draws, counted in cull_stats. */
+static bool visible_sphere(const Frustum *f, float x, float y, float z, float r, int objects) {
+    bool in = frustum_test_sphere(f, x, y, z, r);
+    cull_stats.tested += objects;
+    cull_stats.visible += in ? objects : 0;
+    return in;
+}
+
+void scene_draw(const SceneSnapshot *s, float alpha) {
+    /* built from the snapshot: frame_constants belongs to the simulation side */
+    static FrameConstants view;
+    const FrameConstants *fc = &view;
+    frame_constants_build(&view, &s->engine);
+
+    Frustum frustum;
+    frustum_from_matrix(&frustum, fc->view_proj);
+    memset(&cull_stats, 0, sizeof(cull_stats));
+
+    glClearColor(0.05f, 0.05f, 0.08f, 1);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    program_poll();
+    asset_poll();
+    texture_pump();
+    bool world_ready = program_ready(gl_caps.instancing ? inst_prog : prog);
+    bool axis_ready = program_ready(axis_prog);
+    bool sky_ready = program_ready(sky_prog);   // built up front, but the build may have failed
+
+    rq_begin();
+    rq_frame_uniform(prog, uViewProj, RQ_MAT4, fc->view_proj);
+    rq_frame_uniform(axis_prog, axis_uViewProj, RQ_MAT4, fc->view_proj);
+    if (sky_ready)
+        rq_frame_uniform(sky_prog, sky_uInvViewProj, RQ_MAT4, fc->inv_view_proj);
+    if (gl_caps.instancing)
+        rq_frame_uniform(inst_prog, inst_uViewProj, RQ_MAT4, fc->view_proj);
+
+    /* ================= AXES ================= */
+    RqPacket *p;
+    if (axis_ready && visible_box(&frustum, axis_mesh.bounds_lo, axis_mesh.bounds_hi)) {
+        p = rq_push_mesh(rq_key(RQ_LAYER_OPAQUE, axis_prog, 0, &axis_mesh, 0.0f),
+                         axis_prog, &axis_mesh);
+        rq_uniform(p, axis_uModel, RQ_MAT4, identity);
+    }
+
+    /* ================= CHARACTERS ================= */
+    if (world_ready) {
+        if (gl_caps.instancing)
+            push_characters_instanced(s, alpha, &frustum);
+        else
+            push_characters(s, alpha, fc, &frustum);
+    }
+
+    /* ================= SELECTION RINGS ================= */
+    float ax, ay, az, arot;
+    if (s->selected >= 0)
+        snapshot_pose(s, s->selected, alpha, &ax, &ay, &az, &arot);
+    /* both rings lie within PICK_RADIUS of the character's root */
+    if (s->selected >= 0 && axis_ready && visible_sphere(&frustum, ax, ay, az, PICK_RADIUS, 2)) {
+        /* material 1: after the axes, which share axis_prog with an identity model */
+        uint64_t key = rq_key(RQ_LAYER_OPAQUE, axis_prog, 1, &sel_mesh,
+                              view_depth(fc, ax, ay, az));
+
+        /* ---- XZ RING (GROUND) ---- */
+        float t[16], rx[16], t2[16];
+        mat4_translate(t, ax, ay, az);
+        p = rq_push_mesh(key, axis_prog, &sel_mesh);
+        rq_uniform(p, axis_uModel, RQ_MAT4, t);
+
+        /* ---- XY RING (VERTICAL) ---- */
+        mat4_rotate_x(rx, M_PI * 0.5f);
+        mat4_mul_affine(t2, t, rx);
+        p = rq_push_mesh(key, axis_prog, &sel_mesh);
+        rq_uniform(p, axis_uModel, RQ_MAT4, t2);
+    }
+
+    /* ================= SKYBOX =================
+     * Drawn after the opaque layer at depth 1.0, so only pixels no geometry covered are shaded.
+     */
+    if (sky_ready)
+        rq_push_mesh(rq_key(RQ_LAYER_SKY, sky_prog, 0, &sky_mesh, 0.0f), sky_prog, &sky_mesh);
+
+    /* ================= GRID FLOOR =================
+     * The ground quad follows the eye, snapped to major lines so the pattern stays put in the
+     * world, and reaches past CAM_FAR so the grid has faded out before its edge.
+     */
+    float gx = floorf(fc->eye[0] / GRID_MAJOR) * GRID_MAJOR;
+    float gz = floorf(fc->eye[2] / GRID_MAJOR) * GRID_MAJOR;
+    float extent = CAM_FAR + GRID_MAJOR;
+    float ground_lo[3] = {gx - extent, 0.0f, gz - extent};
+    float ground_hi[3] = {gx + extent, 0.0f, gz + extent};
+    if (program_ready(grid_prog) && visible_box(&frustum, ground_lo, ground_hi)) {
+        float model[16];
+        mat4_scale(model, extent, 1.0f, extent);
+        model[12] = gx;
+        model[14] = gz;
+        /* fade distance, and world units per pixel at depth 1 for contexts without derivatives */
+        float grid[2] = {GRID_STEP, GRID_MAJOR};
+        float fade[2] = {CAM_FAR, 2.0f / (fc->proj[5] * (float) s->engine.height)};
+        rq_frame_uniform(grid_prog, grid_uViewProj, RQ_MAT4, fc->view_proj);
+        rq_frame_uniform(grid_prog, grid_uGrid, RQ_VEC2, grid);
+        rq_frame_uniform(grid_prog, grid_uFade, RQ_VEC2, fade);
+
+        p = rq_push_mesh(rq_key(RQ_LAYER_BLEND, grid_prog, 0, &ground_mesh, 0.0f),
+                         grid_prog, &ground_mesh);
+        rq_uniform(p, grid_uModel, RQ_MAT4, model);
+    }
+
+    /* ================= CURSOR + AXIS BUTTON UI ================= */
+    ui_begin(s->engine.width, s->engine.height);
+    ui_lines(cursor_vertices, 4, s->engine.cursor_ndc_x, s->engine.cursor_ndc_y, 1.0f);
+
+    for (int i = 0; i < 3; i++) {
+        float x = AXIS_BTN_START_X + i * AXIS_BTN_SPACING;
+        bool active = s->engine.active_axis == i;
+        const float *c = axis_btn_color[i];
+
+        ui_circle(x, AXIS_BTN_Y, AXIS_BTN_RADIUS, AXIS_BTN_SEGMENTS, active ? 4.0f : 1.5f,
+                  c[0], c[1], c[2]);
+        /* axis letter */
+        ui_lines(axis_glyph[i], axis_glyph_count[i], x, AXIS_BTN_Y, 1.0f);
+    }
+    ui_flush();
+
+    cull_stats.culled = cull_stats.tested - cull_stats.visible;
+    rq_submit();
+}
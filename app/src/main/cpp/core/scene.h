@@ -0,0 +1,25 @@
+#ifndef U3D_CORE_SCENE_H
+#define U3D_CORE_SCENE_H
+
+#include "snapshot.h"
+#include "transform.h"
+
+/* ================= SCENE =================
+ * Owns every GL object the app uses and submits one frame of draws. Requires a current GL
+ * context (or the host stub) for both calls; presenting the frame is left to the caller.
+ */
+
+/* Uploads meshes, builds programs and the projection for the current engine.width/height.
+ * Program binaries are cached in cache_dir (see program.h); NULL compiles from source. */
+void scene_init(const char *cache_dir);
+
+/* Draws sky, grid, axes, characters and UI overlay for a scene snapshot. Reads nothing but the
+ * snapshot, so it may run while the simulation thread steps. Characters are blended by alpha
+ * (snapshot_alpha) between their last two sim steps. */
+void scene_draw(const SceneSnapshot *s, float alpha);
+
+/* Character transforms as of the last scene_draw: one root per character, then BODY_PARTS
+ * parts each. For checks; the tree belongs to the scene. */
+const TransformTree *scene_character_transforms();
+
+#endif //U3D_CORE_SCENE_H
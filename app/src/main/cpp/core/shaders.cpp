@@ -0,0 +1,194 @@
+#include "shaders.h"
+
+/* ================= WORLD SHADERS ================= */
+
+const char *vs_src =
+        "attribute vec3 aPos;\n"
+        "attribute vec3 aColor;\n"
+        "attribute vec3 aNormal;\n"
+        "uniform mat4 uViewProj;\n"
+        "uniform mat4 uModel;\n"
+        "varying vec3 vColor;\n"
+        "varying vec3 vNormal;\n"
+        "void main(){\n"
+        "  vColor = aColor;\n"
+        "  vNormal = mat3(uModel) * aNormal;\n"
+        "  gl_Position = uViewProj * (uModel * vec4(aPos,1.0));\n"
+        "}\n";
+
+const char *fs_src =
+        "precision mediump float;\n"
+        "varying vec3 vColor;\n"
+        "varying vec3 vNormal;\n"
+        "uniform float uSelected;\n"
+        "void main(){\n"
+        "  vec3 N = normalize(vNormal);\n"
+        "  vec3 L = normalize(vec3(-0.4,-1.0,-0.6));\n"
+        "  vec3 V = vec3(0.0,0.0,1.0);\n"
+        "  float diff = max(dot(N,-L),0.0);\n"
+        "  vec3 base = vColor * (0.25 + diff * 0.75);\n"
+        "  float rim = 1.0 - max(dot(N, V), 0.0);\n"
+        "  rim = smoothstep(0.4, 0.8, rim);\n"
+        "  vec3 outline = vec3(1.0, 0.9, 0.3) * rim * uSelected * 1.5;\n"
+        "  gl_FragColor = vec4(base + outline, 1.0);\n"
+        "}\n";
+
+
+/* ================= INSTANCED WORLD SHADERS (ES3) =================
+ * Same lighting as the world shaders; the model matrix and selection flag arrive per instance.
+ */
+
+const char *inst_vs =
+        "#version 300 es\n"
+        "in vec3 aPos;\n"
+        "in vec3 aColor;\n"
+        "in vec3 aNormal;\n"
+        "in mat4 aModel;\n"
+        "in float aSelected;\n"
+        "uniform mat4 uViewProj;\n"
+        "out vec3 vColor;\n"
+        "out vec3 vNormal;\n"
+        "out float vSelected;\n"
+        "void main(){\n"
+        "  vColor = aColor;\n"
+        "  vNormal = mat3(aModel) * aNormal;\n"
+        "  vSelected = aSelected;\n"
+        "  gl_Position = uViewProj * (aModel * vec4(aPos,1.0));\n"
+        "}\n";
+
+const char *inst_fs =
+        "#version 300 es\n"
+        "precision mediump float;\n"
+        "in vec3 vColor;\n"
+        "in vec3 vNormal;\n"
+        "in float vSelected;\n"
+        "out vec4 fragColor;\n"
+        "void main(){\n"
+        "  vec3 N = normalize(vNormal);\n"
+        "  vec3 L = normalize(vec3(-0.4,-1.0,-0.6));\n"
+        "  vec3 V = vec3(0.0,0.0,1.0);\n"
+        "  float diff = max(dot(N,-L),0.0);\n"
+        "  vec3 base = vColor * (0.25 + diff * 0.75);\n"
+        "  float rim = 1.0 - max(dot(N, V), 0.0);\n"
+        "  rim = smoothstep(0.4, 0.8, rim);\n"
+        "  vec3 outline = vec3(1.0, 0.9, 0.3) * rim * vSelected * 1.5;\n"
+        "  fragColor = vec4(base + outline, 1.0);\n"
+        "}\n";
+
+/* ================= AXIS SHADERS ================= */
+
+const char *axis_vs =
+        "attribute vec3 aPos;\n"
+        "attribute vec3 aColor;\n"
+        "uniform mat4 uViewProj;\n"
+        "uniform mat4 uModel;\n"
+        "varying vec3 vColor;\n"
+        "void main(){\n"
+        "  vColor = aColor;\n"
+        "  gl_Position = uViewProj * (uModel * vec4(aPos,1.0));\n"
+        "}\n";
+
+const char *axis_fs =
+        "precision mediump float;\n"
+        "varying vec3 vColor;\n"
+        "void main(){\n"
+        "  gl_FragColor = vec4(vColor,1.0);\n"
+        "}\n";
+
+/* ================= GRID SHADERS =================
+ * Lines are computed per fragment on one ground quad, so the grid costs the same however far it
+ * reaches. Each family of lines is antialiased to about a pixel from its screen-space footprint
+ * and fades out as its cells shrink towards a pixel, minor lines first; everything fades with
+ * view distance towards uFade.x. Without GL_OES_standard_derivatives the footprint is estimated
+ * from view depth (uFade.y: world units per pixel at depth 1), which ignores the viewing angle.
+ */
+
+const char *grid_vs =
+        "attribute vec3 aPos;\n"
+        "uniform mat4 uViewProj;\n"
+        "uniform mat4 uModel;\n"
+        "varying vec2 vGrid;\n"
+        "varying float vDepth;\n"
+        "void main(){\n"
+        "  vec4 world = uModel * vec4(aPos,1.0);\n"
+        "  vGrid = world.xz - uModel[3].xz;\n"
+        "  gl_Position = uViewProj * world;\n"
+        "  vDepth = gl_Position.w;\n"
+        "}\n";
+
+const char *grid_fs =
+        "#ifdef GL_OES_standard_derivatives\n"
+        "#extension GL_OES_standard_derivatives : enable\n"
+        "#endif\n"
+        "precision mediump float;\n"
+        "varying vec2 vGrid;\n"
+        "varying float vDepth;\n"
+        "uniform vec2 uGrid;\n"
+        "uniform vec2 uFade;\n"
+        "float lines(float spacing){\n"
+        "  vec2 c = vGrid / spacing;\n"
+        "#ifdef GL_OES_standard_derivatives\n"
+        "  vec2 w = max(fwidth(c), vec2(1e-4));\n"
+        "#else\n"
+        "  vec2 w = vec2(max(vDepth * uFade.y / spacing, 1e-4));\n"
+        "#endif\n"
+        "  vec2 d = abs(fract(c - 0.5) - 0.5) / w;\n"
+        "  float line = 1.0 - min(min(d.x, d.y), 1.0);\n"
+        "  return line * (1.0 - smoothstep(0.1, 0.4, max(w.x, w.y)));\n"
+        "}\n"
+        "void main(){\n"
+        "  float minor = lines(uGrid.x);\n"
+        "  float major = lines(uGrid.y);\n"
+        "  float fade = 1.0 - smoothstep(uFade.x * 0.4, uFade.x, vDepth);\n"
+        "  vec3 col = mix(vec3(0.35), vec3(0.55), major);\n"
+        "  gl_FragColor = vec4(col, max(minor * 0.7, major) * fade);\n"
+        "}\n";
+
+/* ================= UI SHADERS (SCREEN SPACE) =================
+ * Vertices arrive in NDC from the UI batch, colour per vertex.
+ */
+const char *ui_vs =
+        "attribute vec2 aPos;\n"
+        "attribute vec4 aColor;\n"
+        "varying vec4 vColor;\n"
+        "void main(){\n"
+        "  vColor = aColor;\n"
+        "  gl_Position = vec4(aPos, 0.0, 1.0);\n"
+        "}\n";
+
+
+const char *ui_fs =
+        "precision mediump float;\n"
+        "varying vec4 vColor;\n"
+        "void main(){\n"
+        "  vec3 glow = vColor.rgb * 2.5;\n"
+        "  gl_FragColor = vec4(glow, vColor.a);\n"
+        "}\n";
+
+/* ================= SKYBOX SHADERS =================
+ * One full-screen triangle at the far plane (z = w, so depth 1.0). The view ray through each
+ * vertex is the difference of its near and far points under the inverse view-projection; both
+ * sit at constant view depth, so the ray interpolates linearly across the screen.
+ */
+
+const char *sky_vs =
+        "attribute vec2 aPos;\n"
+        "uniform mat4 uInvViewProj;\n"
+        "varying vec3 vDir;\n"
+        "void main(){\n"
+        "  vec4 n = uInvViewProj * vec4(aPos, -1.0, 1.0);\n"
+        "  vec4 f = uInvViewProj * vec4(aPos, 1.0, 1.0);\n"
+        "  vDir = f.xyz / f.w - n.xyz / n.w;\n"
+        "  gl_Position = vec4(aPos, 1.0, 1.0);\n"
+        "}\n";
+
+const char *sky_fs =
+        "precision mediump float;\n"
+        "varying vec3 vDir;\n"
+        "void main(){\n"
+        "  vec3 horizon = vec3(0.45, 0.65, 0.95);\n"
+        "  vec3 zenith  = vec3(0.05, 0.10, 0.25);\n"
+        "  float t = clamp(1.0 - ((normalize(vDir).y + 1.0) * 0.5), 0.0, 1.0);\n"
+        "  vec3 col = mix(horizon, zenith, t);\n"
+        "  gl_FragColor = vec4(col, 1.0);\n"
+        "}\n";
@@ -0,0 +1,21 @@
+#ifndef U3D_CORE_SHADERS_H
+#define U3D_CORE_SHADERS_H
+
+#include "gles.h"
+
+/* ================= SHADER SOURCES ================= */
+
+extern const char *vs_src;
+extern const char *fs_src;
+extern const char *inst_vs;
+extern const char *inst_fs;
+extern const char *axis_vs;
+extern const char *axis_fs;
+extern const char *grid_vs;
+extern const char *grid_fs;
+extern const char *ui_vs;
+extern const char *ui_fs;
+extern const char *sky_vs;
+extern const char *sky_fs;
+
+#endif //U3D_CORE_SHADERS_H
@@ -0,0 +1,79 @@
+#include "sim_thread.h"
+#include "config.h"
+#include "pacing.h"
+#include "snapshot.h"
+#include "spsc.h"
+
+#include <atomic>
+#include <pthread.h>
+
+#define SIM_INPUT_QUEUE 256
+
+static pthread_t       thread;
+static pthread_mutex_t idle_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  idle_wake = PTHREAD_COND_INITIALIZER;
+
+static SpscRing          touches;
+static std::atomic<bool> running(false);
+
+static void (*publish_hook)(void *);
+static void *publish_arg;
+
+static void drain_input() {
+    TouchEvent e;
+    while (spsc_pop(&touches, &e))
+        input_touch(&e);
+}
+
+static void *sim_main(void *) {
+    FrameClock clock;
+    frame_clock_monotonic(&clock, SIM_STEP_NS);
+
+    while (running.load(std::memory_order_acquire)) {
+        drain_input();
+
+        if (!frame_needed()) {
+            frame_pacing_reset();
+
+            pthread_mutex_lock(&idle_lock);
+            while (running.load(std::memory_order_acquire) && spsc_empty(&touches))
+                pthread_cond_wait(&idle_wake, &idle_lock);
+            pthread_mutex_unlock(&idle_lock);
+            continue;
+        }
+
+        uint32_t before = snapshot_published();
+        frame_tick(clock.wait(&clock));
+        if (publish_hook && snapshot_published() != before)
+            publish_hook(publish_arg);
+    }
+    return NULL;
+}
+
+static void wake() {
+    pthread_mutex_lock(&idle_lock);
+    pthread_cond_signal(&idle_wake);
+    pthread_mutex_unlock(&idle_lock);
+}
+
+void sim_thread_start(void (*on_publish)(void *arg), void *arg) {
+    if (!touches.items)
+        spsc_init(&touches, sizeof(TouchEvent), SIM_INPUT_QUEUE);
+    publish_hook = on_publish;
+    publish_arg = arg;
+
+    running.store(true, std::memory_order_release);
+    pthread_create(&thread, NULL, sim_main, NULL);
+}
+
+void sim_thread_stop() {
+    running.store(false, std::memory_order_release);
+    wake();
+    pthread_join(thread, NULL);
+}
+
+bool sim_post_touch(const TouchEvent *e) {
+    bool queued = spsc_push(&touches, e);
+    wake();
+    return queued;
+}
@@ -0,0 +1,26 @@
+#ifndef U3D_CORE_SIM_THREAD_H
+#define U3D_CORE_SIM_THREAD_H
+
+#include "input.h"
+
+/* ================= SIMULATION THREAD =================
+ * Runs input handling and frame_tick on a thread of its own at SIM_HZ, so a slow step no longer
+ * delays GL submission and the two overlap on multi-core devices. Once started, the thread owns
+ * the ECS, the spatial index, frame_pacing and the engine global; other threads talk to it only
+ * through sim_post_touch and read it only through scene snapshots (snapshot.h).
+ *
+ * At rest (frame_needed() false) the thread sleeps until the next touch arrives.
+ */
+
+/* Starts the thread. on_publish (may be NULL) is called on the sim thread after each snapshot is
+ * published, e.g. to wake a renderer blocked on its event loop. */
+void sim_thread_start(void (*on_publish)(void *arg), void *arg);
+
+/* Stops and joins the thread; the caller owns the simulation again afterwards. */
+void sim_thread_stop();
+
+/* Queues a touch for the sim thread (producer: one thread only). Returns false if the queue was
+ * full and the event dropped. */
+bool sim_post_touch(const TouchEvent *e);
+
+#endif //U3D_CORE_SIM_THREAD_H
@@ -0,0 +1,90 @@
+#ifndef U3D_CORE_SIMD_H
+#define U3D_CORE_SIMD_H
+
+/* ================= SIMD =================
+ * Four-wide float vector used by the math and simulation hot loops. Picks NEON on ARM, SSE on
+ * x86 and a plain struct everywhere else. Define U3D_FORCE_SCALAR to take the fallback path on
+ * any target (handy for A/B timing in u3d_bench).
+ */
+
+#if !defined(U3D_FORCE_SCALAR) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define U3D_SIMD_NEON 1
+#include <arm_neon.h>
+#elif !defined(U3D_FORCE_SCALAR) && (defined(__SSE__) || defined(_M_X64) || defined(_M_IX86_FP))
+#define U3D_SIMD_SSE 1
+#include <xmmintrin.h>
+#else
+#define U3D_SIMD_SCALAR 1
+#endif
+
+#if defined(U3D_SIMD_NEON)
+
+typedef float32x4_t f4;
+typedef uint32x4_t  f4m;   // per-lane all-ones / all-zeros mask
+
+static inline f4 f4_load(const float *p) { return vld1q_f32(p); }
+static inline void f4_store(float *p, f4 v) { vst1q_f32(p, v); }
+static inline f4 f4_splat(float s) { return vdupq_n_f32(s); }
+static inline f4 f4_add(f4 a, f4 b) { return vaddq_f32(a, b); }
+static inline f4 f4_sub(f4 a, f4 b) { return vsubq_f32(a, b); }
+static inline f4 f4_mul(f4 a, f4 b) { return vmulq_f32(a, b); }
+static inline f4 f4_min(f4 a, f4 b) { return vminq_f32(a, b); }
+static inline f4 f4_max(f4 a, f4 b) { return vmaxq_f32(a, b); }
+#if defined(__aarch64__)
+/* a * b + c */
+static inline f4 f4_madd(f4 a, f4 b, f4 c) { return vfmaq_f32(c, a, b); }
+#else
+static inline f4 f4_madd(f4 a, f4 b, f4 c) { return vmlaq_f32(c, a, b); }
+#endif
+static inline f4 f4_abs(f4 a) { return vabsq_f32(a); }
+static inline f4m f4_ge(f4 a, f4 b) { return vcgeq_f32(a, b); }
+/* a where m is set, 0 elsewhere */
+static inline f4 f4_and(f4 a, f4m m) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), m)); }
+
+#elif defined(U3D_SIMD_SSE)
+
+typedef __m128 f4;
+typedef __m128 f4m;   // per-lane all-ones / all-zeros mask
+
+static inline f4 f4_load(const float *p) { return _mm_loadu_ps(p); }
+static inline void f4_store(float *p, f4 v) { _mm_storeu_ps(p, v); }
+static inline f4 f4_splat(float s) { return _mm_set1_ps(s); }
+static inline f4 f4_add(f4 a, f4 b) { return _mm_add_ps(a, b); }
+static inline f4 f4_sub(f4 a, f4 b) { return _mm_sub_ps(a, b); }
+static inline f4 f4_mul(f4 a, f4 b) { return _mm_mul_ps(a, b); }
+static inline f4 f4_min(f4 a, f4 b) { return _mm_min_ps(a, b); }
+static inline f4 f4_max(f4 a, f4 b) { return _mm_max_ps(a, b); }
+/* a * b + c */
+static inline f4 f4_madd(f4 a, f4 b, f4 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+static inline f4 f4_abs(f4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+static inline f4m f4_ge(f4 a, f4 b) { return _mm_cmpge_ps(a, b); }
+/* a where m is set, 0 elsewhere */
+static inline f4 f4_and(f4 a, f4m m) { return _mm_and_ps(a, m); }
+
+#else
+
+typedef struct { float v[4]; } f4;
+typedef struct { bool v[4]; } f4m;   // per-lane mask
+
+static inline f4 f4_load(const float *p) { f4 r = {{p[0], p[1], p[2], p[3]}}; return r; }
+static inline void f4_store(float *p, f4 a) { p[0] = a.v[0]; p[1] = a.v[1]; p[2] = a.v[2]; p[3] = a.v[3]; }
+static inline f4 f4_splat(float s) { f4 r = {{s, s, s, s}}; return r; }
+#define U3D_F4_OP(name, expr) \
+    static inline f4 name(f4 a, f4 b) { \
+        f4 r; for (int i = 0; i < 4; i++) r.v[i] = (expr); return r; }
+U3D_F4_OP(f4_add, a.v[i] + b.v[i])
+U3D_F4_OP(f4_sub, a.v[i] - b.v[i])
+U3D_F4_OP(f4_mul, a.v[i] * b.v[i])
+U3D_F4_OP(f4_min, a.v[i] < b.v[i] ? a.v[i] : b.v[i])
+U3D_F4_OP(f4_max, a.v[i] > b.v[i] ? a.v[i] : b.v[i])
+#undef U3D_F4_OP
+/* a * b + c */
+static inline f4 f4_madd(f4 a, f4 b, f4 c) { return f4_add(f4_mul(a, b), c); }
+static inline f4 f4_abs(f4 a) { f4 r; for (int i = 0; i < 4; i++) r.v[i] = a.v[i] < 0 ? -a.v[i] : a.v[i]; return r; }
+static inline f4m f4_ge(f4 a, f4 b) { f4m r; for (int i = 0; i < 4; i++) r.v[i] = a.v[i] >= b.v[i]; return r; }
+/* a where m is set, 0 elsewhere */
+static inline f4 f4_and(f4 a, f4m m) { f4 r; for (int i = 0; i < 4; i++) r.v[i] = m.v[i] ? a.v[i] : 0.0f; return r; }
+
+#endif
+
+#endif //U3D_CORE_SIMD_H
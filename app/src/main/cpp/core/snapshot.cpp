@@ -0,0 +1,124 @@
+#include "snapshot.h"
+#include "character.h"
+#include "config.h"
+#include "jobs.h"
+
+#include <atomic>
+#include <stdlib.h>
+#include <string.h>
+
+#define SNAP_FRESH 4   // flag on the middle index: published and not yet acquired
+
+static SceneSnapshot buffers[3];
+
+static int back = 0;                              // sim thread only
+static int front = 2;                             // render thread only
+static bool front_valid = false;                  // render thread only
+static std::atomic<uint8_t> middle(1);
+static std::atomic<uint32_t> published(0);
+
+/* ================= SIM SIDE ================= */
+
+static void reserve(SceneSnapshot *s, int count) {
+    if (count <= s->capacity)
+        return;
+    s->capacity = count * 2;
+    s->entity = (Entity *) realloc(s->entity, sizeof(Entity) * s->capacity);
+    for (int f = 0; f < SNAP_POSE_COUNT; f++)
+        s->pose[f] = (float *) realloc(s->pose[f], sizeof(float) * s->capacity);
+}
+
+static const int capture_src[SNAP_POSE_COUNT] = {
+        FIELD_X, FIELD_Y, FIELD_Z, FIELD_ROT,
+        FIELD_PREV_X, FIELD_PREV_Y, FIELD_PREV_Z, FIELD_PREV_ROT
+};
+
+static EcsChunkList capture_chunks;
+static int *capture_offset;   // first snapshot index of each chunk
+static int  capture_offset_capacity;
+
+/* Column copies per chunk; entities without history get prev = current. */
+static void capture_range(void *arg, int begin, int end) {
+    SceneSnapshot *s = (SceneSnapshot *) arg;
+    for (int i = begin; i < end; i++) {
+        const EcsChunk *c = capture_chunks.chunk[i];
+        int n = capture_offset[i];
+        size_t bytes = sizeof(float) * c->count;
+        memcpy(s->entity + n, c->entity, sizeof(Entity) * c->count);
+        for (int f = 0; f < SNAP_POSE_COUNT; f++) {
+            const float *col = c->field[capture_src[f]];
+            if (!col)
+                col = c->field[capture_src[f - SNAP_PREV_X]];
+            memcpy(s->pose[f] + n, col, bytes);
+        }
+    }
+}
+
+static void capture(SceneSnapshot *s) {
+    reserve(s, ecs_count(CHARACTER_COMPONENTS));
+    s->selected = -1;
+
+    int sel_row;
+    const EcsChunk *sel = ecs_chunk_of(engine.selected, &sel_row);
+
+    ecs_gather(&capture_chunks, CHARACTER_COMPONENTS);
+    if (capture_chunks.count > capture_offset_capacity) {
+        capture_offset_capacity = capture_chunks.capacity;
+        capture_offset = (int *) realloc(capture_offset, sizeof(int) * capture_offset_capacity);
+    }
+
+    int n = 0;
+    for (int i = 0; i < capture_chunks.count; i++) {
+        const EcsChunk *c = capture_chunks.chunk[i];
+        capture_offset[i] = n;
+        if (c == sel)
+            s->selected = n + sel_row;
+        n += c->count;
+    }
+    s->count = n;
+
+    parallel_for(capture_chunks.count, 1, capture_range, s);
+}
+
+void snapshot_publish(int64_t time_ns, bool moving) {
+    SceneSnapshot *s = &buffers[back];
+    s->engine = engine;
+    s->time_ns = time_ns;
+    s->moving = moving;
+    s->seq = published.load(std::memory_order_relaxed) + 1;
+    capture(s);
+
+    /* hand the filled buffer over and take whichever one the reader is not holding */
+    back = middle.exchange((uint8_t) (back | SNAP_FRESH), std::memory_order_acq_rel) & 3;
+    published.store(s->seq, std::memory_order_release);
+}
+
+uint32_t snapshot_published() {
+    return published.load(std::memory_order_acquire);
+}
+
+/* ================= RENDER SIDE ================= */
+
+const SceneSnapshot *snapshot_acquire(bool *fresh) {
+    *fresh = false;
+    if (middle.load(std::memory_order_relaxed) & SNAP_FRESH) {
+        front = middle.exchange((uint8_t) front, std::memory_order_acq_rel) & 3;
+        front_valid = true;
+        *fresh = true;
+    }
+    return front_valid ? &buffers[front] : NULL;
+}
+
+float snapshot_alpha(const SceneSnapshot *s, int64_t frame_ns) {
+    float a = (float) (frame_ns - s->time_ns) / (float) SIM_STEP_NS;
+    return a < 0.0f ? 0.0f : a > 1.0f ? 1.0f : a;
+}
+
+void snapshot_pose(const SceneSnapshot *s, int i, float alpha, float *x, float *y, float *z,
+                   float *rot) {
+    float *const *p = s->pose;
+    *x = p[SNAP_PREV_X][i] + (p[SNAP_X][i] - p[SNAP_PREV_X][i]) * alpha;
+    *y = p[SNAP_PREV_Y][i] + (p[SNAP_Y][i] - p[SNAP_PREV_Y][i]) * alpha;
+    *z = p[SNAP_PREV_Z][i] + (p[SNAP_Z][i] - p[SNAP_PREV_Z][i]) * alpha;
+    *rot = p[SNAP_PREV_ROT][i] + (p[SNAP_ROT][i] - p[SNAP_PREV_ROT][i]) * alpha;
+}
@@ -0,0 +1,57 @@
+#ifndef U3D_CORE_SNAPSHOT_H
+#define U3D_CORE_SNAPSHOT_H
+
+#include "ecs.h"
+#include "engine.h"
+
+#include <stdint.h>
+
+/* ================= SCENE SNAPSHOTS =================
+ * Everything the renderer reads, copied out of the simulation after a step: the engine state
+ * (camera, UI, selection) and the current and previous pose of every character. The renderer
+ * never touches the ECS or the engine global, so the simulation can run on another thread.
+ *
+ * Snapshots travel through a lock-free triple buffer: the simulation fills the back buffer and
+ * publishes it, the renderer acquires the newest published one. Neither side ever waits, the
+ * renderer always sees a complete snapshot, and a snapshot it holds is never written until it
+ * acquires another. Exactly one thread may publish and one may acquire.
+ */
+
+enum SnapshotPose {
+    SNAP_X, SNAP_Y, SNAP_Z, SNAP_ROT,
+    SNAP_PREV_X, SNAP_PREV_Y, SNAP_PREV_Z, SNAP_PREV_ROT,
+    SNAP_POSE_COUNT
+};
+
+typedef struct {
+    Engine   engine;          // as of the step
+    int64_t  time_ns;         // sim time of the current poses (CLOCK_MONOTONIC timeline)
+    bool     moving;          // the step moved something; later frames still interpolate
+    uint32_t seq;             // publish counter
+
+    int      count;           // characters
+    int      selected;        // index of engine.selected, -1 if none
+    int      capacity;
+    Entity  *entity;
+    float   *pose[SNAP_POSE_COUNT];
+} SceneSnapshot;
+
+/* Sim side: copies the characters and engine state into the back buffer and publishes it. */
+void snapshot_publish(int64_t time_ns, bool moving);
+
+/* Number of snapshots published so far (any thread). */
+uint32_t snapshot_published();
+
+/* Render side: the newest published snapshot, or NULL before the first one. *fresh is set when
+ * it was published since the previous acquire. */
+const SceneSnapshot *snapshot_acquire(bool *fresh);
+
+/* Render interpolation factor for a frame at frame_ns: 0 shows the previous pose, 1 the
+ * current one (reached one sim step after the snapshot's time). */
+float snapshot_alpha(const SceneSnapshot *s, int64_t frame_ns);
+
+/* Pose of character i blended by alpha. */
+void snapshot_pose(const SceneSnapshot *s, int i, float alpha, float *x, float *y, float *z,
+                   float *rot);
+
+#endif //U3D_CORE_SNAPSHOT_H
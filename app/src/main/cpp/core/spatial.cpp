@@ -0,0 +1,319 @@
+#include "spatial.h"
+#include "config.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CELL_COORD_MAX ((1 << 20) - 1)   // 21 signed bits per axis in a cell key
+#define EMPTY_KEY      INT64_MIN
+
+/* ================= STORAGE ================= */
+
+/* One per entity slot (see entity_index). */
+typedef struct {
+    Entity  e;            // ENTITY_NONE = not in the index
+    float   x, y, z;
+    int64_t key;
+    int     prev, next;   // neighbours in the cell list, -1 = none
+} Item;
+
+typedef struct {
+    int64_t key;          // EMPTY_KEY = unused bucket
+    int     head;
+    int     count;
+} Cell;
+
+static Item *items;
+static int   item_capacity;
+static int   item_count;
+static unsigned revision;
+
+static Cell *cells;          // open addressing, linear probing, power-of-two size
+static int   cell_capacity;
+static int   cell_used;      // buckets holding a key (including cells that went empty)
+static int   cell_occupied;  // cells with at least one entity
+
+static int cell_coord(float v) {
+    float c = floorf(v * (1.0f / SPATIAL_CELL));
+    if (c >  CELL_COORD_MAX) return  CELL_COORD_MAX;
+    if (c < -CELL_COORD_MAX) return -CELL_COORD_MAX;
+    return (int) c;
+}
+
+static int64_t cell_key(int ix, int iy, int iz) {
+    const uint64_t m = (1u << 21) - 1;
+    return (int64_t) ((((uint64_t) ix & m) << 42) | (((uint64_t) iy & m) << 21) | ((uint64_t) iz & m));
+}
+
+static uint32_t cell_hash(int64_t key) {
+    return (uint32_t) (((uint64_t) key * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+static int cell_find(int64_t key) {
+    if (cell_capacity == 0)
+        return -1;
+    uint32_t mask = cell_capacity - 1;
+    for (uint32_t i = cell_hash(key) & mask;; i = (i + 1) & mask) {
+        if (cells[i].key == key)
+            return (int) i;
+        if (cells[i].key == EMPTY_KEY)
+            return -1;
+    }
+}
+
+static void cell_rehash(int capacity) {
+    Cell *old = cells;
+    int old_capacity = cell_capacity;
+
+    cells = (Cell *) malloc(sizeof(Cell) * capacity);
+    cell_capacity = capacity;
+    cell_used = 0;
+    for (int i = 0; i < capacity; i++)
+        cells[i].key = EMPTY_KEY;
+
+    /* Empty cells are dropped here rather than on removal, so probe chains stay intact. */
+    uint32_t mask = capacity - 1;
+    for (int i = 0; i < old_capacity; i++) {
+        if (old[i].key == EMPTY_KEY || old[i].count == 0)
+            continue;
+        uint32_t j = cell_hash(old[i].key) & mask;
+        while (cells[j].key != EMPTY_KEY)
+            j = (j + 1) & mask;
+        cells[j] = old[i];
+        cell_used++;
+    }
+    free(old);
+}
+
+static int cell_insert(int64_t key) {
+    int found = cell_find(key);
+    if (found >= 0)
+        return found;
+
+    if ((cell_used + 1) * 2 > cell_capacity) {
+        int capacity = cell_capacity ? cell_capacity : 64;
+        while ((cell_occupied + 1) * 4 > capacity)
+            capacity *= 2;
+        cell_rehash(capacity);
+    }
+
+    uint32_t mask = cell_capacity - 1;
+    uint32_t i = cell_hash(key) & mask;
+    while (cells[i].key != EMPTY_KEY)
+        i = (i + 1) & mask;
+    cells[i].key = key;
+    cells[i].head = -1;
+    cells[i].count = 0;
+    cell_used++;
+    return (int) i;
+}
+
+static void unlink_item(int idx) {
+    Item *it = &items[idx];
+    Cell *c = &cells[cell_find(it->key)];
+
+    if (it->prev >= 0) items[it->prev].next = it->next;
+    else               c->head = it->next;
+    if (it->next >= 0) items[it->next].prev = it->prev;
+
+    if (--c->count == 0)
+        cell_occupied--;
+}
+
+static void link_item(int idx, int64_t key) {
+    int ci = cell_insert(key);   // may rehash: index cells only afterwards
+    Cell *c = &cells[ci];
+    Item *it = &items[idx];
+
+    it->key = key;
+    it->prev = -1;
+    it->next = c->head;
+    if (c->head >= 0)
+        items[c->head].prev = idx;
+    c->head = idx;
+
+    if (c->count++ == 0)
+        cell_occupied++;
+}
+
+/* ================= UPDATES ================= */
+
+void spatial_update(Entity e, float x, float y, float z) {
+    if (e == ENTITY_NONE)
+        return;
+    revision++;
+
+    int idx = (int) entity_index(e);
+    if (idx >= item_capacity) {
+        int capacity = item_capacity ? item_capacity : 256;
+        while (capacity <= idx)
+            capacity *= 2;
+        items = (Item *) realloc(items, sizeof(Item) * capacity);
+        for (int i = item_capacity; i < capacity; i++)
+            items[i].e = ENTITY_NONE;
+        item_capacity = capacity;
+    }
+
+    Item *it = &items[idx];
+    int64_t key = cell_key(cell_coord(x), cell_coord(y), cell_coord(z));
+
+    if (it->e == ENTITY_NONE) {
+        item_count++;
+        link_item(idx, key);
+    } else if (it->key != key) {
+        unlink_item(idx);
+        link_item(idx, key);
+    }
+
+    it = &items[idx];
+    it->e = e;
+    it->x = x;
+    it->y = y;
+    it->z = z;
+}
+
+void spatial_remove(Entity e) {
+    if (e == ENTITY_NONE)
+        return;
+
+    int idx = (int) entity_index(e);
+    if (idx >= item_capacity || items[idx].e != e)
+        return;
+
+    unlink_item(idx);
+    items[idx].e = ENTITY_NONE;
+    item_count--;
+    revision++;
+}
+
+void spatial_clear() {
+    for (int i = 0; i < item_capacity; i++)
+        items[i].e = ENTITY_NONE;
+    for (int i = 0; i < cell_capacity; i++)
+        cells[i].key = EMPTY_KEY;
+    item_count = 0;
+    cell_used = 0;
+    cell_occupied = 0;
+    revision++;
+}
+
+int spatial_count() {
+    return item_count;
+}
+
+unsigned spatial_revision() {
+    return revision;
+}
+
+/* ================= QUERIES ================= */
+
+/* Calls fn(item) for every entity in the cells overlapping [lo, hi]. When the box spans more
+ * cells than are occupied it walks the occupied cells instead, so huge boxes cost at most one
+ * pass over the table. */
+template <typename Fn>
+static void visit_box(const float lo[3], const float hi[3], Fn fn) {
+    if (cell_occupied == 0)
+        return;
+
+    int c0[3], c1[3];
+    double span = 1.0;
+    for (int a = 0; a < 3; a++) {
+        c0[a] = cell_coord(lo[a]);
+        c1[a] = cell_coord(hi[a]);
+        span *= (double) (c1[a] - c0[a] + 1);
+    }
+
+    if (span > cell_occupied) {
+        for (int i = 0; i < cell_capacity; i++)
+            if (cells[i].key != EMPTY_KEY)
+                for (int idx = cells[i].head; idx >= 0; idx = items[idx].next)
+                    fn(&items[idx]);
+        return;
+    }
+
+    for (int ix = c0[0]; ix <= c1[0]; ix++)
+        for (int iy = c0[1]; iy <= c1[1]; iy++)
+            for (int iz = c0[2]; iz <= c1[2]; iz++) {
+                int ci = cell_find(cell_key(ix, iy, iz));
+                if (ci < 0)
+                    continue;
+                for (int idx = cells[ci].head; idx >= 0; idx = items[idx].next)
+                    fn(&items[idx]);
+            }
+}
+
+int spatial_query_radius(float x, float y, float z, float r, Entity *out, int max) {
+    float lo[3] = {x - r, y - r, z - r};
+    float hi[3] = {x + r, y + r, z + r};
+    float r2 = r * r;
+    int n = 0;
+
+    visit_box(lo, hi, [&](const Item *it) {
+        float dx = it->x - x, dy = it->y - y, dz = it->z - z;
+        if (n < max && dx * dx + dy * dy + dz * dz <= r2)
+            out[n++] = it->e;
+    });
+    return n;
+}
+
+int spatial_query_aabb(const float lo[3], const float hi[3], Entity *out, int max) {
+    int n = 0;
+
+    visit_box(lo, hi, [&](const Item *it) {
+        if (n < max &&
+            it->x >= lo[0] && it->x <= hi[0] &&
+            it->y >= lo[1] && it->y <= hi[1] &&
+            it->z >= lo[2] && it->z <= hi[2])
+            out[n++] = it->e;
+    });
+    return n;
+}
+
+/* Grows the search radius from one cell until k hits lie inside it: anything outside the
+ * radius is further than every hit, so the k closest inside are the k closest overall. */
+int spatial_query_nearest(float x, float y, float z, int k, float max_dist, Entity *out, float *dist2) {
+    static float *scratch;
+    static int scratch_capacity;
+
+    if (k <= 0)
+        return 0;
+    if (!dist2) {
+        if (k > scratch_capacity) {
+            scratch_capacity = k;
+            scratch = (float *) realloc(scratch, sizeof(float) * k);
+        }
+        dist2 = scratch;
+    }
+
+    int n = 0;
+    for (float r = SPATIAL_CELL;; r *= 2.0f) {
+        if (r > max_dist)
+            r = max_dist;
+
+        float lo[3] = {x - r, y - r, z - r};
+        float hi[3] = {x + r, y + r, z + r};
+        float r2 = r * r;
+        n = 0;
+
+        /* insertion into a sorted list of at most k */
+        visit_box(lo, hi, [&](const Item *it) {
+            float dx = it->x - x, dy = it->y - y, dz = it->z - z;
+            float d2 = dx * dx + dy * dy + dz * dz;
+            if (d2 > r2 || (n == k && d2 >= dist2[k - 1]))
+                return;
+
+            int i = n < k ? n++ : k - 1;
+            for (; i > 0 && dist2[i - 1] > d2; i--) {
+                dist2[i] = dist2[i - 1];
+                out[i] = out[i - 1];
+            }
+            dist2[i] = d2;
+            out[i] = it->e;
+        });
+
+        if (n == k || r >= max_dist || n == item_count)
+            return n;
+    }
+}
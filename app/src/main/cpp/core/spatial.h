@@ -0,0 +1,41 @@
+#ifndef U3D_CORE_SPATIAL_H
+#define U3D_CORE_SPATIAL_H
+
+#include "ecs.h"
+
+/* ================= SPATIAL INDEX =================
+ * Hashed uniform grid over entity positions (cell size SPATIAL_CELL). Only occupied cells are
+ * stored, so the world is unbounded. Each cell keeps an intrusive list of its entities; moving
+ * an entity touches the hash only when it crosses a cell boundary.
+ *
+ * The index holds its own copy of each position: whoever moves an entity calls
+ * spatial_update, and whoever destroys one calls spatial_remove (agent_spawn/agent_destroy and
+ * the input/sim movers already do).
+ */
+
+/* Inserts e or moves it to (x, y, z). */
+void spatial_update(Entity e, float x, float y, float z);
+
+void spatial_remove(Entity e);
+
+/* Empties the index. */
+void spatial_clear();
+
+/* Number of entities in the index. */
+int spatial_count();
+
+/* Bumped by every update/remove/clear. Lets derived structures (the pick BVH) skip work when
+ * nothing has moved since they last looked. */
+unsigned spatial_revision();
+
+/* Entities within r of (x, y, z). Writes at most max handles, returns how many were written. */
+int spatial_query_radius(float x, float y, float z, float r, Entity *out, int max);
+
+/* Entities whose position lies inside the box [lo, hi]. Same output contract as above. */
+int spatial_query_aabb(const float lo[3], const float hi[3], Entity *out, int max);
+
+/* Up to k entities nearest to (x, y, z) and no further than max_dist, closest first. When
+ * dist2 is not NULL it receives the squared distances. Returns how many were found. */
+int spatial_query_nearest(float x, float y, float z, int k, float max_dist, Entity *out, float *dist2);
+
+#endif //U3D_CORE_SPATIAL_H
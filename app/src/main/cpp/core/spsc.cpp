@@ -0,0 +1,36 @@
+#include "spsc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+void spsc_init(SpscRing *r, size_t item_size, uint32_t capacity) {
+    r->head.store(0, std::memory_order_relaxed);
+    r->tail.store(0, std::memory_order_relaxed);
+    r->mask = capacity - 1;
+    r->item_size = item_size;
+    r->items = (uint8_t *) malloc(item_size * capacity);
+}
+
+bool spsc_push(SpscRing *r, const void *item) {
+    uint32_t tail = r->tail.load(std::memory_order_relaxed);
+    if (tail - r->head.load(std::memory_order_acquire) > r->mask)
+        return false;
+
+    memcpy(r->items + (tail & r->mask) * r->item_size, item, r->item_size);
+    r->tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+bool spsc_pop(SpscRing *r, void *item) {
+    uint32_t head = r->head.load(std::memory_order_relaxed);
+    if (head == r->tail.load(std::memory_order_acquire))
+        return false;
+
+    memcpy(item, r->items + (head & r->mask) * r->item_size, r->item_size);
+    r->head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool spsc_empty(const SpscRing *r) {
+    return r->head.load(std::memory_order_acquire) == r->tail.load(std::memory_order_acquire);
+}
@@ -0,0 +1,32 @@
+#ifndef U3D_CORE_SPSC_H
+#define U3D_CORE_SPSC_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/* ================= SPSC RING =================
+ * Bounded lock-free queue of fixed-size items for exactly one producer thread and one consumer
+ * thread. Items are copied in and out. Capacity must be a power of two.
+ */
+
+typedef struct {
+    std::atomic<uint32_t> head;   // next slot to read; written by the consumer
+    std::atomic<uint32_t> tail;   // next slot to write; written by the producer
+    uint32_t mask;
+    size_t   item_size;
+    uint8_t *items;
+} SpscRing;
+
+void spsc_init(SpscRing *r, size_t item_size, uint32_t capacity);
+
+/* Producer side. Fails (and drops the item) when the ring is full. */
+bool spsc_push(SpscRing *r, const void *item);
+
+/* Consumer side. Fails when the ring is empty. */
+bool spsc_pop(SpscRing *r, void *item);
+
+/* Either side; only a hint while the other side is running. */
+bool spsc_empty(const SpscRing *r);
+
+#endif //U3D_CORE_SPSC_H
@@ -0,0 +1,294 @@
+#include "texture.h"
+#include "gl_caps.h"
+#include "gl_state.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+TextureStats texture_stats;
+
+#define TEXTURE_MAX_BANDS 1024   // per frame; a budget spent on 1x1 levels still ends
+
+typedef struct {
+    GLuint       texture;
+    TextureImage image;
+    bool         compressed;
+    int          level, row;     // next row of blocks to upload
+    bool         mipmaps;        // generate the chain after the last row
+    void       (*release)(void *ctx);
+    void        *ctx;
+} Upload;
+
+/* Rows of one level of an upload sent this frame; offset is into the frame's staging buffer. */
+typedef struct {
+    Upload *upload;
+    int     level, row, rows;
+    size_t  offset;
+} Band;
+
+static Upload queue[TEXTURE_MAX];   // pending uploads, in submission order
+static int    queue_count;
+static Band   bands[TEXTURE_MAX_BANDS];
+static GLuint placeholder;
+static GLuint pbo;                  // 0 without gl_caps.pixel_buffers
+static size_t budget;
+
+static void release(Upload *u) {
+    if (u->release)
+        u->release(u->ctx);
+}
+
+void texture_init() {
+    for (int i = 0; i < queue_count; i++)
+        release(&queue[i]);
+    queue_count = 0;
+    memset(&texture_stats, 0, sizeof(texture_stats));
+    budget = TEXTURE_UPLOAD_BUDGET;
+
+    static const uint8_t grey[4] = {128, 128, 128, 255};
+    glGenTextures(1, &placeholder);
+    glBindTexture(GL_TEXTURE_2D, placeholder);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, grey);
+
+    pbo = 0;
+    if (gl_caps.pixel_buffers)
+        glGenBuffers(1, &pbo);
+}
+
+void texture_set_budget(int bytes) {
+    budget = bytes > 0 ? (size_t) bytes : 0;
+}
+
+static int mip_levels(int width, int height) {
+    int levels = 1;
+    for (int size = width > height ? width : height; size > 1; size >>= 1)
+        levels++;
+    return levels;
+}
+
+static bool power_of_two(int n) {
+    return (n & (n - 1)) == 0;
+}
+
+static int level_size(int size, int level) {
+    size >>= level;
+    return size > 0 ? size : 1;
+}
+
+static size_t row_bytes(const TextureImage *image, int level) {
+    int width = level_size(image->width, level);
+    return (size_t) ((width + image->block_width - 1) / image->block_width) *
+           image->block_bytes;
+}
+
+static int block_rows(const TextureImage *image, int level) {
+    int height = level_size(image->height, level);
+    return (height + image->block_height - 1) / image->block_height;
+}
+
+size_t texture_level_size(const TextureImage *image, int level) {
+    return row_bytes(image, level) * block_rows(image, level);
+}
+
+static GLuint submit(const TextureImage *image, bool mipmaps, void (*release)(void *),
+                     void *ctx) {
+    if (queue_count == TEXTURE_MAX || image->width <= 0 || image->height <= 0 ||
+        image->levels < 1 || image->levels > TEXTURE_MAX_LEVELS) {
+        if (release)
+            release(ctx);
+        return 0;
+    }
+
+    Upload *u = &queue[queue_count++];
+    u->image = *image;
+    u->compressed = image->block_width > 1 || image->block_height > 1;
+    u->level = 0;
+    u->row = 0;
+    u->mipmaps = mipmaps;
+    u->release = release;
+    u->ctx = ctx;
+    if (gl_caps.es_major < 3) {
+        /* ES2 takes a chain only when it is complete down to 1x1; generating one is simpler */
+        bool pot = power_of_two(image->width) && power_of_two(image->height);
+        u->mipmaps = (mipmaps || image->levels > 1) && pot;
+        u->image.levels = 1;
+    }
+    int levels = u->mipmaps ? mip_levels(image->width, image->height) : u->image.levels;
+
+    /* storage only: allocating is cheap, it is the texels that are worth spreading out */
+    glGenTextures(1, &u->texture);
+    glBindTexture(GL_TEXTURE_2D, u->texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                    levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    if (gl_caps.es_major >= 3)
+        glTexStorage2D(GL_TEXTURE_2D, levels, image->internal_format, image->width,
+                       image->height);
+    else
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image->width, image->height, 0, GL_RGBA,
+                     GL_UNSIGNED_BYTE, NULL);
+
+    for (int level = 0; level < levels; level++)
+        texture_stats.memory += texture_level_size(&u->image, level);
+    texture_stats.textures++;
+    texture_stats.pending++;
+    return u->texture;
+}
+
+GLuint texture_submit(uint8_t *pixels, int width, int height, bool mipmaps) {
+    TextureImage image = {GL_RGBA8, width, height, 1, 1, 4, 1, {pixels}};
+    return submit(&image, mipmaps && width > 0 && height > 0, free, pixels);
+}
+
+GLuint texture_submit_image(const TextureImage *image, void (*release)(void *ctx), void *ctx) {
+    return submit(image, false, release, ctx);
+}
+
+/* Splits the budget into whole rows of blocks of the queued uploads, oldest first and level by
+ * level. Returns the band count and the bytes they cover in *total. */
+static int plan_bands(size_t *total) {
+    int count = 0;
+    size_t bytes = 0;
+    for (int i = 0; i < queue_count; i++) {
+        const Upload *u = &queue[i];
+        int level = u->level, row = u->row;
+        while (level < u->image.levels) {
+            if (count == TEXTURE_MAX_BANDS)
+                goto done;
+            size_t size = row_bytes(&u->image, level);
+            int rows = bytes < budget ? (int) ((budget - bytes) / size) : 0;
+            if (rows == 0 && bytes == 0)
+                rows = 1;   // a budget below one row still makes progress
+            if (rows == 0)
+                goto done;
+            if (rows > block_rows(&u->image, level) - row)
+                rows = block_rows(&u->image, level) - row;
+            bands[count++] = {&queue[i], level, row, rows, bytes};
+            bytes += size * rows;
+            row += rows;
+            if (row == block_rows(&u->image, level)) {
+                level++;
+                row = 0;
+            }
+        }
+    }
+done:
+    *total = bytes;
+    return count;
+}
+
+static const uint8_t *band_source(const Band *b) {
+    const TextureImage *image = &b->upload->image;
+    return image->level[b->level] + row_bytes(image, b->level) * b->row;
+}
+
+/* Copies every band into the orphaned unpack buffer and leaves it bound. False (with nothing
+ * bound) if the buffer could not be mapped or its contents were lost on unmap. */
+static bool stage_bands(int count, size_t total) {
+    gls_bind_buffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr) total, NULL, GL_STREAM_DRAW);
+    uint8_t *staging = (uint8_t *) glMapBufferRange(
+            GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr) total,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (staging) {
+        for (int i = 0; i < count; i++) {
+            const Band *b = &bands[i];
+            memcpy(staging + b->offset, band_source(b),
+                   row_bytes(&b->upload->image, b->level) * b->rows);
+        }
+        if (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE)
+            return true;
+    }
+    gls_bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return false;
+}
+
+void texture_pump() {
+    texture_stats.frame_bytes = 0;
+    if (queue_count == 0)
+        return;
+
+    size_t total;
+    int count = plan_bands(&total);
+    bool staged = pbo && stage_bands(count, total);
+
+    for (int i = 0; i < count; i++) {
+        const Band *b = &bands[i];
+        Upload *u = b->upload;
+        const TextureImage *image = &u->image;
+        const void *src = staged ? (const void *) b->offset : band_source(b);
+        int width = level_size(image->width, b->level);
+        int height = level_size(image->height, b->level);
+        int y = b->row * image->block_height;
+        int rows = b->rows * image->block_height;
+        if (rows > height - y)
+            rows = height - y;   // the last row of blocks may hang over the edge
+        glBindTexture(GL_TEXTURE_2D, u->texture);
+        if (u->compressed)
+            glCompressedTexSubImage2D(GL_TEXTURE_2D, b->level, 0, y, width, rows,
+                                      image->internal_format,
+                                      (GLsizei) (row_bytes(image, b->level) * b->rows), src);
+        else
+            glTexSubImage2D(GL_TEXTURE_2D, b->level, 0, y, width, rows, GL_RGBA,
+                            GL_UNSIGNED_BYTE, src);
+        u->level = b->level;
+        u->row = b->row + b->rows;
+        if (u->row == block_rows(image, u->level)) {
+            u->level++;
+            u->row = 0;
+        }
+        if (u->level == image->levels && u->mipmaps)
+            glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    /* with the buffer bound, texture_submit's NULL data would read as an offset into it */
+    if (staged)
+        gls_bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    /* the texels are in GL's hands now, staged or copied by glTex(Compressed)SubImage2D */
+    int kept = 0;
+    for (int i = 0; i < queue_count; i++) {
+        if (queue[i].level < queue[i].image.levels) {
+            queue[kept++] = queue[i];
+            continue;
+        }
+        release(&queue[i]);
+        texture_stats.pending--;
+    }
+    queue_count = kept;
+
+    texture_stats.bytes += total;
+    texture_stats.frame_bytes = (int) total;
+    if (texture_stats.frame_bytes > texture_stats.peak_frame_bytes)
+        texture_stats.peak_frame_bytes = texture_stats.frame_bytes;
+}
+
+static int find(GLuint texture) {
+    for (int i = 0; i < queue_count; i++)
+        if (queue[i].texture == texture)
+            return i;
+    return -1;
+}
+
+bool texture_ready(GLuint texture) {
+    return texture && find(texture) < 0;
+}
+
+GLuint texture_resolve(GLuint texture) {
+    return texture_ready(texture) ? texture : placeholder;
+}
+
+void texture_delete(GLuint texture) {
+    int i = find(texture);
+    if (i >= 0) {
+        release(&queue[i]);
+        memmove(&queue[i], &queue[i + 1], sizeof(Upload) * (queue_count - i - 1));
+        queue_count--;
+        texture_stats.pending--;
+    }
+    if (texture)
+        glDeleteTextures(1, &texture);
+}
@@ -0,0 +1,90 @@
+#ifndef U3D_CORE_TEXTURE_H
+#define U3D_CORE_TEXTURE_H
+
+#include "gles.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ================= TEXTURES =================
+ * Streams images into GPU memory a slice at a time. texture_submit takes a decoded RGBA8 image,
+ * texture_submit_image one with its mip chain already built in any format the context samples
+ * (RGBA8, ETC2, ASTC); both return the texture name at once, with storage allocated but no
+ * texels. texture_pump, called once per frame, uploads whole rows (of blocks, for compressed
+ * formats) of the queued images, level by level in submission order, until the frame's byte
+ * budget is spent, so a large image arrives over several frames instead of stalling one. Until
+ * the last row has landed (and the mip chain has been generated, if asked for) texture_resolve
+ * hands out a 1x1 grey placeholder in its place, so draws can bind the result every frame
+ * without caring whether it has arrived.
+ *
+ * With pixel buffer objects (gl_caps.pixel_buffers) a frame's rows are copied into one orphaned
+ * GL_PIXEL_UNPACK_BUFFER and the glTex(Compressed)SubImage2D calls source from it, so the
+ * driver transfers them asynchronously instead of copying client memory inside the call. On
+ * ES2 the same rows go straight from client memory, still bounded by the budget.
+ *
+ * Everything here runs on the GL thread.
+ */
+
+#define TEXTURE_MAX           256
+#define TEXTURE_MAX_LEVELS    16
+#define TEXTURE_UPLOAD_BUDGET (512 * 1024)   // default bytes per frame
+
+typedef struct {
+    int      textures;          // submitted
+    int      pending;           // not yet complete
+    uint64_t bytes;             // texel bytes uploaded
+    uint64_t memory;            // storage allocated for every submitted texture
+    int      frame_bytes;       // uploaded by the last texture_pump
+    int      peak_frame_bytes;
+} TextureStats;
+
+extern TextureStats texture_stats;
+
+/* An image laid out as GL takes it: each level tightly packed rows of blocks, in the order
+ * glTexImage2D reads texel rows. Uncompressed RGBA8 is 1x1 blocks of 4 bytes. */
+typedef struct {
+    GLenum internal_format;   // GL_RGBA8, GL_SRGB8_ALPHA8 or a GL_COMPRESSED_* format
+    int    width, height;     // level 0, in texels
+    int    block_width, block_height, block_bytes;
+    int    levels;
+    const uint8_t *level[TEXTURE_MAX_LEVELS];   // level 0 first
+} TextureImage;
+
+/* Forgets every queued upload (call once per new context, after gl_caps_init), creates the
+ * placeholder and sets the budget to TEXTURE_UPLOAD_BUDGET. */
+void texture_init();
+
+/* Bytes texture_pump may upload per frame. At least one row is uploaded per frame whatever the
+ * budget, so a queue always drains. */
+void texture_set_budget(int bytes);
+
+/* Queues a width x height image of tightly packed RGBA8 rows, in the order glTexImage2D reads
+ * them. Takes ownership of pixels, which must come from malloc and is freed once uploaded.
+ * mipmaps generates the full chain after the last row (ignored on ES2 for non-power-of-two
+ * sizes, which cannot be mipmapped there). Returns the texture name, or 0 (freeing pixels) if
+ * TEXTURE_MAX textures are pending. */
+GLuint texture_submit(uint8_t *pixels, int width, int height, bool mipmaps);
+
+/* Queues image with its levels as given; the context must sample its format (compressed ones
+ * need ES3). The level data must stay valid until release(ctx) is called, from texture_pump or
+ * texture_delete, or at once if 0 is returned. On ES2 only level 0 is uploaded and the rest of
+ * the chain is generated, as far as the image had one and is a power of two. Returns the
+ * texture name, or 0 if TEXTURE_MAX textures are pending. */
+GLuint texture_submit_image(const TextureImage *image, void (*release)(void *ctx), void *ctx);
+
+/* Bytes of one level of image. */
+size_t texture_level_size(const TextureImage *image, int level);
+
+/* Uploads queued rows up to the budget; call once per frame. */
+void texture_pump();
+
+/* Whether every texel of texture has been uploaded. */
+bool texture_ready(GLuint texture);
+
+/* texture once it is ready, the placeholder until then. */
+GLuint texture_resolve(GLuint texture);
+
+/* Deletes texture, dropping whatever of it is still queued. */
+void texture_delete(GLuint texture);
+
+#endif //U3D_CORE_TEXTURE_H
@@ -0,0 +1,102 @@
+#include "transform.h"
+#include "jobs.h"
+#include "mat4.h"
+
+#include <atomic>
+#include <stdlib.h>
+#include <string.h>
+
+#define UPDATE_GRAIN 512   // nodes per job
+
+void transform_clear(TransformTree *t) {
+    t->count = 0;
+    t->depth_count = 0;
+}
+
+static int depth_of(const TransformTree *t, int node) {
+    int d = 0;
+    while (d < t->depth_count && node >= t->level_end[d])
+        d++;
+    return d;
+}
+
+int transform_add(TransformTree *t, int parent, const float *local) {
+    if (parent >= t->count)
+        return -1;
+    int depth = parent < 0 ? 0 : depth_of(t, parent) + 1;
+    if (depth >= TRANSFORM_MAX_DEPTH || depth < t->depth_count - 1)
+        return -1;
+
+    if (t->count == t->capacity) {
+        t->capacity = t->capacity ? t->capacity * 2 : 64;
+        t->parent = (int *) realloc(t->parent, sizeof(int) * t->capacity);
+        t->flags = (uint8_t *) realloc(t->flags, t->capacity);
+        t->local = (float *) realloc(t->local, sizeof(float) * 16 * t->capacity);
+        t->world = (float *) realloc(t->world, sizeof(float) * 16 * t->capacity);
+    }
+
+    int n = t->count++;
+    t->parent[n] = parent;
+    t->flags[n] = TRANSFORM_DIRTY;
+    if (local)
+        memcpy(t->local + n * 16, local, sizeof(float) * 16);
+    else
+        mat4_identity(t->local + n * 16);
+
+    if (depth == t->depth_count)
+        t->depth_count++;
+    t->level_end[depth] = t->count;
+    return n;
+}
+
+void transform_set_local(TransformTree *t, int node, const float *local) {
+    float *m = t->local + node * 16;
+    if (memcmp(m, local, sizeof(float) * 16) == 0)
+        return;
+    memcpy(m, local, sizeof(float) * 16);
+    t->flags[node] |= TRANSFORM_DIRTY;
+}
+
+/* ================= UPDATE =================
+ * Parents sit on earlier levels, so by the time a level is swept every parent's MOVED flag is
+ * final for this update. Nodes within a level are independent and split across jobs.
+ */
+
+typedef struct {
+    TransformTree   *t;
+    int              level_begin;
+    std::atomic<int> moved;
+} UpdateJob;
+
+static void update_range(void *arg, int begin, int end) {
+    UpdateJob *job = (UpdateJob *) arg;
+    TransformTree *t = job->t;
+    int moved = 0;
+    for (int i = job->level_begin + begin; i < job->level_begin + end; i++) {
+        int p = t->parent[i];
+        if (!(t->flags[i] & TRANSFORM_DIRTY) && (p < 0 || !(t->flags[p] & TRANSFORM_MOVED))) {
+            t->flags[i] = 0;
+            continue;
+        }
+        if (p < 0)
+            memcpy(t->world + i * 16, t->local + i * 16, sizeof(float) * 16);
+        else
+            mat4_mul_affine(t->world + i * 16, t->world + p * 16, t->local + i * 16);
+        t->flags[i] = TRANSFORM_MOVED;
+        moved++;
+    }
+    job->moved.fetch_add(moved, std::memory_order_relaxed);
+}
+
+int transform_update(TransformTree *t) {
+    UpdateJob job;
+    job.t = t;
+    job.moved.store(0, std::memory_order_relaxed);
+
+    job.level_begin = 0;
+    for (int d = 0; d < t->depth_count; d++) {
+        parallel_for(t->level_end[d] - job.level_begin, UPDATE_GRAIN, update_range, &job);
+        job.level_begin = t->level_end[d];
+    }
+    return job.moved.load(std::memory_order_relaxed);
+}
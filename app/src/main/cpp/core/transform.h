@@ -0,0 +1,55 @@
+#ifndef U3D_CORE_TRANSFORM_H
+#define U3D_CORE_TRANSFORM_H
+
+#include <stdint.h>
+
+/* ================= TRANSFORM HIERARCHY =================
+ * Parent/child transforms in flat arrays sorted by depth: every root comes first, then every
+ * depth-1 node, and so on, so a parent always precedes its children and an update is one linear
+ * sweep per level. Each node caches its local matrix; its world matrix (parent world * local) is
+ * recomputed only when the local changed or an ancestor's world did.
+ *
+ * Nodes are added in depth order and addressed by index. A level's world matrices sit
+ * contiguously in `world`, in the order the nodes were added, so a level can be uploaded as-is
+ * (e.g. as per-instance model matrices).
+ */
+
+#define TRANSFORM_MAX_DEPTH 8
+
+/* flags */
+#define TRANSFORM_DIRTY 1   // local changed since the last update
+#define TRANSFORM_MOVED 2   // world was recomputed by the last update
+
+typedef struct {
+    int      count;
+    int      capacity;
+    int      depth_count;                       // levels in use
+    int      level_end[TRANSFORM_MAX_DEPTH];    // one past the last node of each level
+    int     *parent;                            // -1 for roots
+    uint8_t *flags;
+    float   *local;                             // 16 floats per node
+    float   *world;                             // 16 floats per node
+} TransformTree;
+
+/* Removes every node; storage is kept. */
+void transform_clear(TransformTree *t);
+
+/* Adds a node under parent (-1 for a root) with the given local matrix (NULL = identity) and
+ * returns its index. The parent must already exist, and nodes must be added level by level:
+ * a node may not be shallower than the one added before it. Returns -1 if that is violated or
+ * TRANSFORM_MAX_DEPTH is exceeded. */
+int transform_add(TransformTree *t, int parent, const float *local);
+
+/* Replaces a node's local matrix; marks it dirty only if the value actually changed. Nodes may
+ * be set from several threads at once as long as each thread sets different nodes. */
+void transform_set_local(TransformTree *t, int node, const float *local);
+
+/* Recomputes the world matrix of every dirty node and of everything below one, level by level
+ * (each level fans out over the job system). Returns how many world matrices were recomputed. */
+int transform_update(TransformTree *t);
+
+static inline const float *transform_world(const TransformTree *t, int node) {
+    return t->world + node * 16;
+}
+
+#endif //U3D_CORE_TRANSFORM_H
@@ -0,0 +1,109 @@
+#include "ui.h"
+#include "gles.h"
+#include "mesh.h"
+#include "program.h"
+#include "render_queue.h"
+#include "shaders.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+UiStats ui_stats;
+
+typedef struct {
+    float   x, y;
+    uint8_t color[4];
+} UiVertex;
+
+static GLuint    prog;
+static Mesh      mesh;
+static UiVertex *vertices;
+static int       vertex_count, vertex_capacity;
+static float     ndc_x, ndc_y;   // NDC per pixel
+
+void ui_init() {
+    static const char *const attribs[] = {"aPos", "aColor"};
+    prog = program_build(ui_vs, ui_fs, attribs, 2, NULL);
+
+    static const MeshFormat format[] = {
+            {2, GL_FLOAT, GL_FALSE, 0},
+            {4, GL_UNSIGNED_BYTE, GL_TRUE, 8},
+    };
+    mesh_dynamic(&mesh, GL_TRIANGLES, format, 2, sizeof(UiVertex));
+}
+
+void ui_begin(int width, int height) {
+    vertex_count = 0;
+    ui_stats.lines = 0;
+    ndc_x = 2.0f / (float) (width > 0 ? width : 1);
+    ndc_y = 2.0f / (float) (height > 0 ? height : 1);
+}
+
+static uint8_t unorm8(float v) {
+    if (v < 0.0f) v = 0.0f;
+    if (v > 1.0f) v = 1.0f;
+    return (uint8_t) (v * 255.0f + 0.5f);
+}
+
+static void vertex(UiVertex *v, float x, float y, const uint8_t *color) {
+    v->x = x;
+    v->y = y;
+    v->color[0] = color[0];
+    v->color[1] = color[1];
+    v->color[2] = color[2];
+    v->color[3] = color[3];
+}
+
+void ui_line(float x0, float y0, float x1, float y1, float width, float r, float g, float b) {
+    /* direction in pixels, so the width comes out the same at any angle and aspect */
+    float dx = (x1 - x0) / ndc_x, dy = (y1 - y0) / ndc_y;
+    float len = sqrtf(dx * dx + dy * dy);
+    if (len == 0.0f)
+        return;
+    float half = width * 0.5f / len;
+
+    /* half a width along the line (square caps, so polylines join without gaps) and across */
+    float ax = dx * half * ndc_x, ay = dy * half * ndc_y;
+    float nx = -dy * half * ndc_x, ny = dx * half * ndc_y;
+
+    if (vertex_count + 6 > vertex_capacity) {
+        vertex_capacity = vertex_capacity ? vertex_capacity * 2 : 1024;
+        vertices = (UiVertex *) realloc(vertices, sizeof(UiVertex) * vertex_capacity);
+    }
+    uint8_t color[4] = {unorm8(r), unorm8(g), unorm8(b), 255};
+    UiVertex *v = vertices + vertex_count;
+    vertex(&v[0], x0 - ax + nx, y0 - ay + ny, color);
+    vertex(&v[1], x0 - ax - nx, y0 - ay - ny, color);
+    vertex(&v[2], x1 + ax - nx, y1 + ay - ny, color);
+    vertex(&v[3], x0 - ax + nx, y0 - ay + ny, color);
+    vertex(&v[4], x1 + ax - nx, y1 + ay - ny, color);
+    vertex(&v[5], x1 + ax + nx, y1 + ay + ny, color);
+    vertex_count += 6;
+    ui_stats.lines++;
+}
+
+void ui_lines(const float *v, int count, float x, float y, float width) {
+    for (int i = 0; i + 1 < count; i += 2, v += 10)
+        ui_line(v[0] + x, v[1] + y, v[5] + x, v[6] + y, width, v[2], v[3], v[4]);
+}
+
+void ui_circle(float x, float y, float radius, int segments, float width,
+               float r, float g, float b) {
+    float px = x + radius, py = y;
+    for (int i = 1; i <= segments; i++) {
+        float a = (float) i / segments * 2.0f * (float) M_PI;
+        float cx = x + cosf(a) * radius, cy = y + sinf(a) * radius;
+        ui_line(px, py, cx, cy, width, r, g, b);
+        px = cx;
+        py = cy;
+    }
+}
+
+void ui_flush() {
+    ui_stats.vertices = vertex_count;
+    /* program_build returns 0 on failure; the overlay is then left out, not drawn with it */
+    if (vertex_count == 0 || !program_ready(prog))
+        return;
+    mesh_stream(&mesh, vertices, vertex_count);
+    rq_push_mesh(rq_key(RQ_LAYER_UI, prog, 0, &mesh, 0.0f), prog, &mesh);
+}
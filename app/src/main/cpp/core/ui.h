@@ -0,0 +1,42 @@
+#ifndef U3D_CORE_UI_H
+#define U3D_CORE_UI_H
+
+#include <stdint.h>
+
+/* ================= UI BATCH =================
+ * Immediate-mode 2D overlay. Widgets add lines in NDC as the frame is built; each one is
+ * expanded on the CPU into a quad of the requested width in pixels, with its colour in the
+ * vertices, and appended to one vertex array. ui_flush streams the array into a single buffer
+ * and queues one RQ_LAYER_UI draw, so the HUD costs one upload and one draw call however many
+ * widgets it has. Unlike glLineWidth, widths above 1 pixel work on every device.
+ *
+ * Call order per frame: ui_begin, any number of ui_* primitives, ui_flush (before rq_submit).
+ */
+
+typedef struct {
+    int lines;      // primitives added by the last frame
+    int vertices;   // uploaded by the last ui_flush
+} UiStats;
+
+extern UiStats ui_stats;
+
+/* Builds the program and the streaming mesh. Requires a current GL context (or the stub). */
+void ui_init();
+
+/* Starts a new batch for a width x height pixel viewport. */
+void ui_begin(int width, int height);
+
+/* Line from (x0, y0) to (x1, y1) in NDC, width pixels wide, colour rgb in [0, 1]. */
+void ui_line(float x0, float y0, float x1, float y1, float width, float r, float g, float b);
+
+/* GL_LINES-style list of count vertices, pos(2) color(3) as in geometry.h, offset by (x, y). */
+void ui_lines(const float *vertices, int count, float x, float y, float width);
+
+/* Circle outline around (x, y), radius in NDC on both axes. */
+void ui_circle(float x, float y, float radius, int segments, float width,
+               float r, float g, float b);
+
+/* Uploads the batch and queues its draw. */
+void ui_flush();
+
+#endif //U3D_CORE_UI_H